@@ -1,4 +1,4 @@
-gcc -finput-charset=UTF-8  -D__KERNEL__ -pg -g -lm -O4 -o main main.c
+gcc -finput-charset=UTF-8  -D__KERNEL__ -pg -g -O4 -o main main.c -lpthread -lm
 ctags -R --exclude=dox
 # ./main data/bit.csv 16
 # ./main data/hm_1.csv 2
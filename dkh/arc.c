@@ -16,10 +16,11 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <time.h>
 #include "dk_list.h"
 #include "errno.h"
-#include "md5.h"
-#include "md5.c"
+#include "hash.h"
+#include "trace.h"
 
 /* Get.. */
 #include <memory.h>
@@ -34,9 +35,9 @@
 #define MAX(a, b) ( (a > b) ? (a) : (b) )
 #define MIN(a, b) ( (a < b) ? (a) : (b) )
 
-/* READ WRITE FLAGS */
-#define READ  1
-#define WRITE 2
+#include "slab.h"
+#include "htab.h"
+#include "tinylfu.h"
 
 /* SIZE */
 #define KB (1024)
@@ -50,17 +51,34 @@
 
 #define DEBUG_OPTION 0
 
-struct workload
-{/*{{{*/
-  char *time;
-  char *host;
-  int disk_num;
-  int type;
-  long long offset;
-  long size;
-  long respone; //respones time
-
-};/*}}}*/
+/* POLICY (cache_mem.policy, index of cache_policy[] in policy.h) */
+#define POLICY_ARC 0
+#define POLICY_CAR 1
+#define POLICY_LRU 2
+#define POLICY_2Q 3
+#define POLICY_LIRS 4
+#define POLICY_CLOCKPRO 5
+#define POLICY_S3FIFO 6
+#define POLICY_SIEVE 7
+
+/* cache_line.flag */
+#define LINE_PREFETCH 0x1       /* read ahead, no demand access yet */
+#define LINE_DIRTY 0x2          /* write back. not in backend yet */
+#define LINE_TEST 0x8           /* cold line in test period (CLOCK-Pro) */
+
+/* Write policy (cache_opt.wmode) */
+#define WB_NONE 0               /* write is cached, no backend write */
+#define WB_THROUGH 1
+#define WB_BACK 2
+
+/* Tenant mode (cache_opt.tenant) */
+#define TENANT_OFF 0            /* line is block. volumes collide */
+#define TENANT_SHARED 1         /* one cache, line is (tenant, block) */
+#define TENANT_STATIC 2         /* partition per tenant, equal quota */
+#define TENANT_DYN 3            /* partition, quota moves by ghost hit */
+
+/* line = tenant << TENANT_SHIFT | block */
+#define TENANT_SHIFT 48
 
 struct cache_line
 {/*{{{*/
@@ -68,7 +86,20 @@ struct cache_line
   struct list_head head;
   struct list_head hash;
   struct cache_state *state;
-  unsigned char md5[33];
+  void *data;               /* user data of resident line */
+  unsigned char ref;        /* reference bit (CAR) */
+  unsigned char flag;       /* LINE_* */
+  unsigned int wpos;        /* dirty queue position (low 32 bit, write back) */
+};/*}}}*/
+
+/* Request level hit. (one read request is one backend I/O on miss) */
+struct req_stat
+{/*{{{*/
+  long req;
+  long full;                /* every block hit. backend I/O saved (read) */
+  long partial;             /* some block hit */
+  unsigned long long byte;  /* request byte */
+  double hit_byte;          /* hit block share of request byte */
 };/*}}}*/
 
 struct cache_state
@@ -79,7 +110,8 @@ struct cache_state
 
 struct arc_hash
 {/*{{{*/
-  long long size;
+  long long size;           /* 2^bits */
+  unsigned int bits;
   struct list_head *bucket;
 };/*}}}*/
 
@@ -87,72 +119,90 @@ struct cache_mem
 {/*{{{*/
   /* unsigned long c, p; */
   long c, p;
+  long kin, kout;           /* 2Q. max A1in, A1out */
+  long lir, lir_max;        /* LIRS. LIR count, max */
+  long nr_max;              /* LIRS. max non-resident HIR */
+  struct list_head *hand_hot, *hand_cold, *hand_test;  /* CLOCK-Pro */
+  int policy;
   struct cache_state mrug, mru, mfu, mfug;
 
   long size;
   long max;
+  long block;               /* block size (byte) */
 
   long read;
   long write;
   long hit;
+  long b1_hit;              /* ghost hit (p trajectory) */
+  long b2_hit;
+  long evicted;             /* resident line left cache */
+  struct req_stat rreq, wreq;   /* read, write request */
 
   struct arc_hash hash;
+  struct slab slab;         /* cache_line pool. (c lines + c ghosts) */
+
+  void (*release)(void *data);  /* line data is dropped. (to ghost or free) */
+  void (*evict)(struct cache_mem *cm, struct cache_line *l);  /* line leaves cache */
+
+  struct tinylfu *admit;    /* ARC admission filter or NULL */
+  struct prefetch *pf;      /* readahead or NULL (prefetch.h) */
+  struct writeback *wb;     /* write policy or NULL (writeback.h) */
+  struct latency *lat;      /* latency model or NULL (latency.h) */
+  struct tenant *tn;        /* tenant key, partition or NULL (tenant.h) */
+  long long key;            /* line = key | block. (tenant << TENANT_SHIFT) */
+
+  /* Engine without cache_line. (fifo.c) */
+  void *priv;
+  void (*priv_free)(void *priv);
+  unsigned long long priv_meta;   /* byte */
 };/*}}}*/
 
 
-unsigned long atonum(char *c);
 int init_hash_list(struct cache_mem *cm, unsigned long s);
 struct cache_mem *init_cache_mem(unsigned long c);
+unsigned long long meta_cm(struct cache_mem *cm);
 void report_cm(struct cache_mem *cm);
 int print_cm(struct cache_mem *cm);
-static int *get_hash(char *ret, long long test, long long size);
-static int *get_hash_md5(char *ret, long long test);
+static inline struct list_head *ARC_bucket(struct cache_mem *cm, long long line);
 struct cache_line *ARC_state_lru(struct cache_state *state);
 int contain_list(struct cache_mem *cm, struct cache_line *l);
+static inline void line_unlink(struct cache_line *l);
+static inline struct cache_line *line_move(struct cache_mem *cm, struct cache_line *l,
+    struct cache_state *state);
 struct cache_line *ARC_move(struct cache_mem *cm, struct cache_line *l, struct cache_state *state);
-static void ARC_balance(struct cache_mem *cm, unsigned long size);
+static inline void ARC_replace(struct cache_mem *cm, int b2);
+static void ARC_balance(struct cache_mem *cm, struct cache_line *l);
 static inline struct cache_line *ARC_print(struct list_head *start);
 int del_cm(struct cache_mem *cm);
 static inline struct cache_line *ARC_lookup(struct cache_mem *cm, long long line);
-static struct cache_line *create_line(long long line, long long max);
+static struct cache_line *create_line(struct cache_mem *cm, long long line);
 void hash_insert(struct cache_mem *cm, struct cache_line *l);
+static inline int ARC_admit(struct cache_mem *cm, long long line);
 struct cache_line *ARC_cache(struct cache_mem *cm, long long line);
-int run_cache(struct cache_mem *cm, struct workload *wl);
-FILE *open_workload(char *file);
-int read_column(struct workload *wl, char *buf);
-int read_workload(FILE *fp, long cache_size);
-
-/** 
- * ASCII to long.
- * Hash string to number.
- * @param c : string
- * @return : unsigned long type number.
- */
-unsigned long atonum(char *c)
-{/*{{{*/
-  unsigned long ret = 0;
-  int i = 0, len = strlen(c);
-  while (len--) {
-    ret += c[i++];
-    ret <<= 4;
-  }
-  return ret;
-}/*}}}*/
+void ARC_stats(struct cache_mem *cm);
+void prefetch_free(struct prefetch *pf);
+void wb_free(struct writeback *wb);
+void lat_free(struct latency *lat);
+void tenant_free(struct tenant *tn);
+static int run_line(struct cache_mem *cm, struct workload *wl);
 
 /** 
  * Init Hash table
  * @param cm : cache mem.
- * @param s : hash table size.
+ * @param s : hash table size. (round up to 2^n)
  * @return : error code.
  */
 int init_hash_list(struct cache_mem *cm, unsigned long s)
 {/*{{{*/
   long i = 0;
 
-  cm->hash.size = s;
-  cm->hash.bucket = malloc(s * sizeof(struct list_head));
+  cm->hash.bits = hash_bits(s);
+  cm->hash.size = 1LL << cm->hash.bits;
+  cm->hash.bucket = malloc(cm->hash.size * sizeof(struct list_head));
+  if (!cm->hash.bucket)
+    return -1;
 
-  for (i = 0; i < s; i++) {
+  for (i = 0; i < cm->hash.size; i++) {
     init_list(&cm->hash.bucket[i]);
   }
 
@@ -176,23 +226,115 @@ struct cache_mem *init_cache_mem(unsigned long c)
   init_list(&cm->mru.head);
   init_list(&cm->mfu.head);
   init_list(&cm->mfug.head);
+  cm->mrug.size = cm->mru.size = cm->mfu.size = cm->mfug.size = 0;
 
   /* Init c & p */
   cm->c = c;
   cm->p = c >> 1;
+  cm->kin = c >> 2;
+  cm->kout = c >> 1;
+  cm->lir = cm->lir_max = cm->nr_max = 0;
+  cm->hand_hot = cm->hand_cold = cm->hand_test = NULL;
+  cm->admit = NULL;
+  cm->pf = NULL;
+  cm->wb = NULL;
+  cm->lat = NULL;
+  cm->tn = NULL;
+  cm->key = 0;
+  cm->priv = NULL;
+  cm->priv_free = NULL;
+  cm->priv_meta = 0;
 
   /* Init */
   cm->size = 0;
   cm->max = c;
+  cm->block = CACHE_BLOCK_SIZE;
+  cm->release = NULL;
+  cm->evict = NULL;
+  cm->policy = POLICY_ARC;
   cm->read = 0;
   cm->write = 0;
   cm->hit = 0;
-
-  init_hash_list(cm, c);
+  cm->b1_hit = cm->b2_hit = 0;
+  cm->evicted = 0;
+  memset(&cm->rreq, 0, sizeof(struct req_stat));
+  memset(&cm->wreq, 0, sizeof(struct req_stat));
+
+  /* T1 + T2 + B1 + B2 <= 2c. (+1 new line before balance) */
+  if (init_hash_list(cm, c) < 0 ||
+      slab_init(&cm->slab, sizeof(struct cache_line), 2 * c + 1) < 0) {
+    free(cm->hash.bucket);
+    free(cm);
+    return NULL;
+  }
 
   return cm;
 }/*}}}*/
 
+/**
+ * Metadata memory. line slab + hash bucket + engine.
+ * @param cm : cache memory struct
+ * @return : byte
+ */
+unsigned long long meta_cm(struct cache_mem *cm)
+{/*{{{*/
+  return cm->priv_meta + (cm->admit ? tlfu_bytes(cm->admit) : 0) + cm->slab.nchunk * sizeof(struct slab_chunk) +
+    (unsigned long long)cm->slab.cap * cm->slab.size +
+    cm->hash.size * sizeof(struct list_head);
+}/*}}}*/
+
+/**
+ * Add one request to request stat.
+ * @param r : request stat
+ * @param wl : request
+ * @param block : block size (byte)
+ * @param hit : number of hit block
+ */
+static inline void req_count(struct req_stat *r, struct workload *wl, long block, long hit)
+{/*{{{*/
+  long n = (wl->offset + wl->size) / block - wl->offset / block + 1;
+
+  r->req++;
+  r->byte += wl->size;
+  if (hit == n) {
+    r->full++;
+    r->hit_byte += wl->size;
+  } else if (hit) {
+    r->partial++;
+    r->hit_byte += (double)wl->size * hit / n;
+  }
+}/*}}}*/
+
+/**
+ * Add one request.
+ * @param cm : cache memory struct
+ * @param wl : request
+ * @param hit : number of hit block
+ */
+static inline void req_add(struct cache_mem *cm, struct workload *wl, int hit)
+{/*{{{*/
+  req_count(wl->type == READ ? &cm->rreq : &cm->wreq, wl, cm->block, hit);
+}/*}}}*/
+
+/**
+ * Print request level hit.
+ * Write hit still goes to backend (write through, flush), so saved I/O is read
+ * only. write side is in wb_stats.
+ * @param name : Read, Write
+ * @param r : request stat
+ * @param read : read request. (print saved I/O)
+ */
+static void req_report(char *name, struct req_stat *r, int read)
+{/*{{{*/
+  printf("%s req : full %ld, partial %ld, miss %ld / %ld (full %.2f%%), "
+      "byte hit %.2f%%", name, r->full, r->partial,
+      r->req - r->full - r->partial, r->req, r->req ? 100.0 * r->full / r->req : 0,
+      r->byte ? 100.0 * r->hit_byte / r->byte : 0);
+  if (read)
+    printf(", backend I/O saved %ld", r->full);
+  printf("\n");
+}/*}}}*/
+
 /**
  * Report result. 
  * @param cm : cache memory struct
@@ -203,6 +345,17 @@ void report_cm(struct cache_mem *cm)
   printf("List (%10ld/%10ld)\n", cm->size, cm->max);
   printf("Read (%10ld/%10ld)\n", cm->hit, cm->read);
   printf("Write(%10ld/%10ld)\n", cm->write, cm->write);
+  req_report("Read ", &cm->rreq, 1);
+  req_report("Write", &cm->wreq, 0);
+  slab_report(&cm->slab, "cache_line");
+  printf("Meta : %llu byte, %.2f byte/cached block\n", meta_cm(cm),
+      cm->c ? (double)meta_cm(cm) / cm->c : 0);
+  if (cm->admit) {
+    printf("Admit : %llu/%llu (%.2f%%), sketch %llu byte, aging %llu\n",
+        cm->admit->admit, cm->admit->candidate,
+        cm->admit->candidate ? 100.0 * cm->admit->admit / cm->admit->candidate : 100,
+        tlfu_bytes(cm->admit), cm->admit->reset);
+  }
   printf("========== report ==========\n");
 }/*}}}*/
 
@@ -246,44 +399,14 @@ int print_cm(struct cache_mem *cm)
 }/*}}}*/
 
 /**
- * get hash number. and saved ret.
- * @param ret : saved string pointer
+ * Hash bucket of line.
+ * @param cm : cache memory.
  * @param line : line number. hash target.
- * @param size : max size.
- * @return : 0.
- */
-static int *get_hash(char *ret, long long line, long long size)
-{/*{{{*/
-
-  sprintf(ret, "%lld", line % size);
-
-  return 0;
-	// return hex_output;
-}/*}}}*/
-
-/**
- * Tmp. Kill Me.
+ * @return : bucket list head.
  */
-static int *get_hash_md5(char *ret, long long test)
+static inline struct list_head *ARC_bucket(struct cache_mem *cm, long long line)
 {/*{{{*/
-	md5_state_t state;
-	md5_byte_t digest[16];
-	char hex_output[16*2 + 1];
-	int di;
-  char str[33] = {'\0', };
-
-  sprintf(str, "%lld", test);
-
-	md5_init(&state);
-	md5_append(&state, (const md5_byte_t *)str, strlen(str));
-	md5_finish(&state, digest);
-
-	for (di = 0; di < 16; ++di)
-		sprintf(hex_output + di * 2, "%02x", digest[di]);
-
-  strcpy(ret, hex_output);
-  return 0;
-	// return hex_output;
+  return &cm->hash.bucket[hash_64(line, cm->hash.bits)];
 }/*}}}*/
 
 /**  
@@ -302,8 +425,10 @@ struct cache_line *ARC_state_lru(struct cache_state *state)
  */
 int contain_list(struct cache_mem *cm, struct cache_line *l)
 {/*{{{*/
-  if (!cm || !l || !l->state)
+  if (!cm || !l || !l->state) {
     printf("new node.. \n");
+    return 0;
+  }
 
   if (l->state == &cm->mrug) {
     printf("mrug %ld \n", l->state->size);
@@ -314,108 +439,145 @@ int contain_list(struct cache_mem *cm, struct cache_line *l)
   } else if (l->state == &cm->mfu) {
     printf("mfu %ld \n", l->state->size);
     return 3;
-  } else if (l->state == &cm->mrug) {
+  } else if (l->state == &cm->mfug) {
     printf("mfug %ld \n", l->state->size);
     return 4;
   }
+
+  return 0;
 }/*}}}*/
 
 /**
- * ARC move.
- * @param cm : cache memory pointer.
+ * Unlink line from its list. (line is kept in hash)
  * @param l : target cache line.
- * @param state : target place.
- * @return : line (TODO : change >> void)
  */
-struct cache_line *ARC_move(struct cache_mem *cm, struct cache_line *l, struct cache_state *state) 
+static inline void line_unlink(struct cache_line *l)
 {/*{{{*/
-
-  /* printf("this %p %p %p %lld ", &l->head, &l->hash, l, l->line); */
-  /* contain_list(cm, l); */
-
-  //이미 있는거 제거..//
   if (l->state) {
     l->state->size -= 1;
-
     list_remove(&l->head);
+    l->state = NULL;
   }
+}/*}}}*/
+
+/**
+ * Move line to head of list. (no balance)
+ * @param cm : cache memory pointer.
+ * @param l : target cache line.
+ * @param state : target place. NULL is destroy.
+ * @return : line or NULL (destroyed)
+ */
+static inline struct cache_line *line_move(struct cache_mem *cm, struct cache_line *l,
+    struct cache_state *state)
+{/*{{{*/
+  /* Leave cache (to ghost or free). drop data */
+  if ((l->state == &cm->mru || l->state == &cm->mfu) &&
+      state != &cm->mru && state != &cm->mfu) {
+    cm->evicted++;
+    if (cm->evict)
+      cm->evict(cm, l);
+    if (l->data && cm->release)
+      cm->release(l->data);
+    l->data = NULL;
+  }
+
+  //이미 있는거 제거..//
+  line_unlink(l);
 
   /* destroy */
   if (state == NULL) {
-    /* printf("del %lld ", l->line); */
-    /* contain_list(cm, l); */
-
     l->line = 0;
-    l->state = NULL;
     list_remove(&l->hash);
 
-    free(l);
-    
+    slab_free(&cm->slab, l);
     return NULL;
-  } else {
-
-    if (state == &cm->mrug || state == &cm->mfug) {
+  }
 
-    } else if (l->state != &cm->mru && l->state != &cm->mfu) {
-      /* printf("bal %p %p %p %lld ", &l->head, &l->hash, l, l->line); */
-      /* contain_list(cm, l); */
+  list_prepend(&l->head, &state->head);
+  l->state = state;
+  l->state->size += 1;
+  return l;
+}/*}}}*/
 
-      ARC_balance(cm, 1);
-    }
+/**
+ * ARC move.
+ * Line comes into cache (mru, mfu) from outside, make room first.
+ * @param cm : cache memory pointer.
+ * @param l : target cache line.
+ * @param state : target place.
+ * @return : line (TODO : change >> void)
+ */
+struct cache_line *ARC_move(struct cache_mem *cm, struct cache_line *l, struct cache_state *state) 
+{/*{{{*/
 
-    list_prepend(&l->head, &state->head);
-    l->state = state;
-    l->state->size += 1;
+  /* printf("this %p %p %p %lld ", &l->head, &l->hash, l, l->line); */
+  /* contain_list(cm, l); */
 
-    /* printf("move %p %p %p %lld ", &l->head, &l->hash, l, l->line); */
+  if ((state == &cm->mru || state == &cm->mfu) &&
+      l->state != &cm->mru && l->state != &cm->mfu) {
+    /* printf("bal %p %p %p %lld ", &l->head, &l->hash, l, l->line); */
     /* contain_list(cm, l); */
-    /* printf("move %p ok. head : %p / size : %lu / val : %lld \n", l, &state->head, l->state->size, l->line); */
 
+    /* l is still in its ghost list. REPLACE needs it (B2 hit) */
+    ARC_balance(cm, l);
   }
-  return l;
+
+  return line_move(cm, l, state);
 }/*}}}*/
 
 /**
- * Balance the lists so that we can fit an object with the given size into
- * the cache. 
+ * ARC REPLACE(x, p). (Megiddo & Modha, FAST 03)
+ * Demote LRU of T1 to B1 if T1 is over target p, else LRU of T2 to B2.
  * @param cm : cahce memory.
- * @param size : added size.
+ * @param b2 : x is B2 hit. (T1 == p also demotes T1)
  */
-static void ARC_balance(struct cache_mem *cm, unsigned long size)
+static inline void ARC_replace(struct cache_mem *cm, int b2)
 {/*{{{*/
+  if (cm->mru.size > 0 &&
+      (cm->mru.size > cm->p || (b2 && cm->mru.size == cm->p) || cm->mfu.size == 0))
+    line_move(cm, ARC_state_lru(&cm->mru), &cm->mrug);
+  else if (cm->mfu.size > 0)
+    line_move(cm, ARC_state_lru(&cm->mfu), &cm->mfug);
+}/*}}}*/
 
-  struct cache_line *l = NULL;
+/**
+ * Make room for line l before it comes into cache.
+ * Ghost hit (case II, III) : REPLACE only.
+ * New line (case IV) : keep T1 + B1 <= c and directory <= 2c, then REPLACE.
+ * @param cm : cahce memory.
+ * @param l : incoming line. (in mrug, mfug or new)
+ */
+static void ARC_balance(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  long t = cm->mru.size + cm->mfu.size;
 
-  /*  First move objects from MRU/MFU to their respective ghost lists. */
-  while (cm->mru.size + cm->mfu.size + size > cm->c) {
-    /* printf("bal : goto G . mur.size = %ld, p = %ld \n", cm->mru.size, cm->p); */
-    if (cm->mru.size > cm->p) {
-      l = ARC_state_lru(&cm->mru);
-      ARC_move(cm, l, &cm->mrug);
-    } else if (cm->mfu.size > 0) {
-      l = ARC_state_lru(&cm->mfu);
-      ARC_move(cm, l, &cm->mfug);
-    } else {
-      break;
-    }
+  /* Case II, III */
+  if (l->state == &cm->mrug || l->state == &cm->mfug) {
+    if (t >= cm->c)
+      ARC_replace(cm, l->state == &cm->mfug);
+    return;
   }
 
-  /*  Then start removing objects from the ghost lists. */
-  while (cm->mrug.size + cm->mfug.size> cm->c) {
-
-    /* printf("bal : goto NULL \n"); */
-    if (cm->mfug.size > cm->p) {
-      l = ARC_state_lru(&cm->mfug);
-      ARC_move(cm, l, NULL);
-    } else if (cm->mrug.size > 0) {
-      l = ARC_state_lru(&cm->mrug);
-      ARC_move(cm, l, NULL);
+  /* Case IV-A : L1 (T1 + B1) is full */
+  if (cm->mru.size + cm->mrug.size >= cm->c) {
+    if (cm->mru.size < cm->c) {
+      line_move(cm, ARC_state_lru(&cm->mrug), NULL);
+      if (t >= cm->c)
+        ARC_replace(cm, 0);
     } else {
-      break;
+      /* B1 is empty. drop LRU of T1 without ghost */
+      line_move(cm, ARC_state_lru(&cm->mru), NULL);
     }
+    return;
   }
 
-  /* printf("bal : end \n"); */
+  /* Case IV-B : L1 < c, directory is full */
+  if (t + cm->mrug.size + cm->mfug.size >= cm->c) {
+    if (t + cm->mrug.size + cm->mfug.size >= 2 * cm->c && cm->mfug.size)
+      line_move(cm, ARC_state_lru(&cm->mfug), NULL);
+    if (t >= cm->c)
+      ARC_replace(cm, 0);
+  }
 }/*}}}*/
 
 /**
@@ -442,34 +604,25 @@ static inline struct cache_line *ARC_print(struct list_head *start)
 
 /**
  * Del cache memory.(cache list)
+ * Every line is in cache_line slab. free at once.
  * @param cm : cache memory struct.
  * @return : error code.
  */
 int del_cm(struct cache_mem *cm)
 {/*{{{*/
-  int i = 0;
-
-  struct list_head *tmp = NULL;
-  struct cache_line *l = NULL;
-
   if (!cm)
     return -1;
 
-  // tmp = cm->list;
-  if (!tmp)
-    return -3;
-
-  /* Del list node */
-  while (i < cm->size) {
-    tmp = tmp->next;
-    l = container_of(tmp, struct cache_line, head);
-
-    // del
-    list_del(tmp->prev);
-    free(l);
-    i++;
-  }
+  if (cm->priv_free)
+    cm->priv_free(cm->priv);
+  tlfu_free(cm->admit);
+  prefetch_free(cm->pf);
+  wb_free(cm->wb);
+  lat_free(cm->lat);
+  tenant_free(cm->tn);
 
+  slab_destroy(&cm->slab);
+  free(cm->hash.bucket);
   free(cm);
   return 0;
 }/*}}}*/
@@ -482,19 +635,13 @@ int del_cm(struct cache_mem *cm)
 static inline struct cache_line *ARC_lookup(struct cache_mem *cm, long long line)
 {/*{{{*/
   struct list_head *tmp = NULL;
-  unsigned long hash_num = NULL;
-  char hash_str[33] = {'\0', };
 
   if (!cm || line < 0)
     return NULL;
 
-  get_hash(hash_str, line, cm->hash.size);
-
   // Get hash.. //
-  hash_num = atonum(hash_str) % (cm->hash.size);
-  list_each(tmp, &cm->hash.bucket[hash_num]) {
+  list_each(tmp, ARC_bucket(cm, line)) {
     struct cache_line *l = list_entry(tmp, struct cache_line, hash);
-    /* if (strncmp(l->md5, hash_str, 33) == 0) { */
     if (line == l->line) {
       return l;
     } 
@@ -505,22 +652,23 @@ static inline struct cache_line *ARC_lookup(struct cache_mem *cm, long long line
 
 /**
  * Make new line.
+ * @param cm : cache memory. (line pool)
  * @param line : line.
- * @param max : for hash modular.
  * @return : new cache line.
  */
-static struct cache_line *create_line(long long line, long long max)
+static struct cache_line *create_line(struct cache_mem *cm, long long line)
 {/*{{{*/
-  struct cache_line *l = malloc(sizeof(struct cache_line));
+  struct cache_line *l = slab_alloc(&cm->slab);
 
   if (!l)
     return NULL;
 
   l->line = line;
-
-  // Init hash..//
-  get_hash(l->md5, line, max);
-  /* printf("create : %s\n", l->md5); */
+  l->state = NULL;
+  l->data = NULL;
+  l->ref = 0;
+  l->flag = 0;
+  l->wpos = 0;
 
   // Init list..//
   init_list(&l->head);
@@ -536,8 +684,30 @@ static struct cache_line *create_line(long long line, long long max)
  */
 void hash_insert(struct cache_mem *cm, struct cache_line *l)
 {/*{{{*/
-  unsigned long hash = atonum(l->md5) % (cm->c);
-  list_prepend(&l->hash, &cm->hash.bucket[hash]);
+  list_prepend(&l->hash, ARC_bucket(cm, l->line));
+}/*}}}*/
+
+/**
+ * TinyLFU admission of new line. (case IV)
+ * Victim is the line ARC would evict for it.
+ * @param cm : cache memory.
+ * @param line : new line
+ * @return : 1 (admit), 0 (reject. no line, no ghost)
+ */
+static inline int ARC_admit(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *victim = NULL;
+
+  /* Not full. free space */
+  if (cm->mru.size + cm->mfu.size < cm->c)
+    return 1;
+
+  if (cm->mru.size > 0 && (cm->mru.size >= cm->c || cm->mru.size > cm->p || cm->mfu.size == 0))
+    victim = ARC_state_lru(&cm->mru);
+  else
+    victim = ARC_state_lru(&cm->mfu);
+
+  return tlfu_admit(cm->admit, line, victim->line);
 }/*}}}*/
 
 /**
@@ -545,6 +715,7 @@ void hash_insert(struct cache_mem *cm, struct cache_line *l)
  * cache line.
  * @param cm : cache memory.
  * @param line : line
+ * @return : line (hit in mru, mfu) or NULL (miss, ghost hit)
  */
 struct cache_line *ARC_cache(struct cache_mem *cm, long long line)
 {/*{{{*/
@@ -552,12 +723,14 @@ struct cache_line *ARC_cache(struct cache_mem *cm, long long line)
   struct cache_line *lookup = NULL;
   struct cache_line *new = NULL;
 
+  if (cm->admit)
+    tlfu_add(cm->admit, line);
+
   lookup = ARC_lookup(cm, line);
 
   if (lookup) {
 
     /* cm->hit++; */
-    /* printf("hit %s\n", lookup->md5); */
     if (lookup->state == &cm->mru || lookup->state == &cm->mfu) {
       /* printf("== 01 %ld %ld %ld %ld\n", cm->mrug.size, cm->mru.size, cm->mfu.size, cm->mfug.size); */
 
@@ -567,21 +740,22 @@ struct cache_line *ARC_cache(struct cache_mem *cm, long long line)
       /* printf("== 02 %ld %ld %ld %ld\n", cm->mrug.size, cm->mru.size, cm->mfu.size, cm->mfug.size); */
       /* contain_list(cm, lookup); */
 
-      /* printf("chp1 : %ld \n", cm->p); */
-      /* cm->p = MIN(cm->c, cm->p + MAX(cm->mfug.size / cm->mrug.size, 1)); */
-      /* printf("chp2 : %ld \n", cm->p); */
+      /* Case II : B1 hit. T1 target grows */
+      cm->p = MIN(cm->c, cm->p + MAX(cm->mfug.size / cm->mrug.size, 1));
+      cm->b1_hit++;
 
+      /* Ghost hit is miss. (no data) */
       ARC_move(cm, lookup, &cm->mfu);
-      return lookup;
+      return NULL;
     } else if (lookup->state == &cm->mfug) {
       /* printf("== 03 %ld %ld %ld %ld\n", cm->mrug.size, cm->mru.size, cm->mfu.size, cm->mfug.size); */
 
-      /* printf("chp1 : %ld, test : %ld\n", cm->p, cm->p - MAX(cm->mrug.size / cm->mfug.size, 1)); */
-      /* cm->p = MAX(0, cm->p - MAX(cm->mrug.size / cm->mfug.size, 1)); */
-      /* printf("chp2 : %ld \n", cm->p); */
+      /* Case III : B2 hit. T1 target shrinks */
+      cm->p = MAX(0, cm->p - MAX(cm->mrug.size / cm->mfug.size, 1));
+      cm->b2_hit++;
 
       ARC_move(cm, lookup, &cm->mfu);
-      return lookup;
+      return NULL;
     } else {
       /* ... */
       return NULL;
@@ -591,7 +765,10 @@ struct cache_line *ARC_cache(struct cache_mem *cm, long long line)
     /* Case4 : New line */
     /* printf("== 04 %ld %ld %ld %ld\n", cm->mrug.size, cm->mru.size, cm->mfu.size, cm->mfug.size); */
 
-    new = create_line(line, cm->hash.size);
+    if (cm->c <= 0 || (cm->admit && !ARC_admit(cm, line)))
+      return NULL;
+
+    new = create_line(cm, line);
     if (!new)
       return NULL;
 
@@ -604,191 +781,221 @@ struct cache_line *ARC_cache(struct cache_mem *cm, long long line)
 }/*}}}*/
 
 /**
- * run cache.
+ * ARC, CAR stats. (list size, p, ghost hit)
  * @param cm : cache memory info strcut
- * @param wl : target workload struct
- * @return : error code
  */
-int run_cache(struct cache_mem *cm, struct workload *wl)
+void ARC_stats(struct cache_mem *cm)
 {/*{{{*/
-  int i = 0;
-  struct cache_line *ret = NULL;
-  long long start = 0;
-  long long end = 0;
-
-  /* NULL arg */
-  if (!cm || !wl) {
-    printf("[FAIL] arg NULL, %s \n", __func__);
-    return -1;
-  }
-
-  /* start sector number and size(end) */
-  // printf("1 s : %.2f , c : %.2f \n", wl->offset, wl->size);
-  // printf("2 s : %.2f , c : %.2f \n", wl->offset/4096, wl->size/4096);
-  start = (wl->offset / CACHE_BLOCK_SIZE);
-  end = ((wl->offset + wl->size) / CACHE_BLOCK_SIZE);
-  // printf("3 s : %14.2f, c : %14.2f \n", start, end);
-
-  /* print */
-  // printf("%d %20s %15ld %10.2f %10ld %5.2f\n", wl->type, wl->time, wl->offset, start, wl->size, end);
-
-   do {
-     // printf("%d >> %f\n", wl->type, start + i);
-
-     /* ret is errno or hit */
-     ret = ARC_cache(cm, start + i);
-
-     /* printf("===== MRUG =====\n"); */
-     /* ARC_print(&(cm->mrug.head)); */
-     /* printf("===== MRU =====\n"); */
-     /* ARC_print(&(cm->mru.head)); */
-     /* printf("===== MFU =====\n"); */
-     /* ARC_print(&(cm->mfu.head)); */
-     /* printf("===== MFUG =====\n"); */
-     /* ARC_print(&(cm->mfug.head)); */
-     /* printf("===========\n"); */
-
-     if (wl->type == READ) {
-       cm->read++;
-       if (ret) {
-         cm->hit++;
-         /* printf(">> hit\n"); */
-       }
-     } else if (wl->type == WRITE) {
-       cm->write++;
-     }
-
-     i++;
-   } while (start + i <= end);
-
-   return 0;
+  printf("===== Info =====\n");
+  printf("mrug %ld \n", cm->mrug.size);
+  printf("mru %ld \n", cm->mru.size);
+  printf("mfu %ld \n", cm->mfu.size);
+  printf("mfug %ld \n", cm->mfug.size);
+  printf("p %ld, b1 hit %ld, b2 hit %ld \n", cm->p, cm->b1_hit, cm->b2_hit);
 }/*}}}*/
 
+#include "car.c"
+#include "lru.c"
+#include "twoq.c"
+#include "lirs.c"
+#include "clockpro.c"
+#include "fifo.c"
+#include "policy.h"
+#include "prefetch.h"
+#include "writeback.h"
+#include "latency.h"
+#include "tenant.h"
+#include "window.h"
+
 /**
- * Just open file and return.
- * @param file : target file path
- * @return : file pointer
+ * Replay one request block by block through policy table.
+ * (readahead or write policy is on. slower than POLICY_RUN)
+ * @param cm : cache memory info strcut
+ * @param wl : target workload struct
+ * @return : number of hit block
  */
-FILE *open_workload(char *file)
+static int run_line(struct cache_mem *cm, struct workload *wl)
 {/*{{{*/
-  FILE *fp = NULL;
-
-  /* NULL arg */
-  if (!file) {
-    printf("[FAIL] arg NULL, %s \n", __func__);
-    return NULL;
+  struct cache_policy *cp = &cache_policy[cm->policy];
+  long long key = cm->key;
+  long long start = wl->offset / cm->block;
+  long long end = (wl->offset + wl->size) / cm->block;
+  long long i = 0;
+  int hit = 0, n = 0;
+
+  for (i = start; i <= end; i++) {
+    /* Prefetch was first touch. resident, not promoted */
+    if (cm->pf && prefetch_demand(cm, key | i, wl->type))
+      hit = 1;
+    else
+      hit = !!cp->access(cm, key | i);
+    n += hit;
+    if (wl->type == READ) {
+      cm->read++;
+      cm->hit += hit;
+    } else if (wl->type == WRITE) {
+      cm->write++;
+      if (cm->wb)
+        wb_write(cm, key | i);
+    }
   }
 
-  /* open FILE */
-  if ((fp = fopen(file, "r")) < 0)
-    return NULL;
-
-  return fp;
+  if (cm->pf)
+    prefetch_stream(cm, (long long)wl->host << 16 | wl->disk_num, start, end);
+  return n;
 }/*}}}*/
 
 /**
- * read colum. (=Inscribe workload struct)
- * @param wl : workload struct
- * @param buf : buffer string
- * @return : error code
+ * run cache. one request.
+ * Block loop is specialized per policy. (POLICY_RUN in policy.h)
+ * @param cm : cache memory info strcut
+ * @param wl : target workload struct
+ * @return : number of hit block or error code
  */
-int read_column(struct workload *wl, char *buf)
+int run_cache(struct cache_mem *cm, struct workload *wl)
 {/*{{{*/
-  int column = 1;
-  char *tmp = NULL;
+  int hit = 0;
 
   /* NULL arg */
-  if (!wl || !buf) {
+  if (!cm || !wl) {
     printf("[FAIL] arg NULL, %s \n", __func__);
     return -1;
   }
-  
-  /* read file and, save workload struct */
-  tmp = strtok(buf, ",");
-  while (tmp != NULL) {
-
-    switch (column) {
-      /* 
-       * TODO : strdup is cause of memory leak
-       * But, This case is needless..
-       */
-
-      // case 1 : wl->time = strdup(tmp); break;
-      // case 2 : wl->host = strdup(tmp); break;
-      // case 3 : wl->disk_num = atoi(tmp); break;
-      case 4 : (wl->type) = (strcmp(tmp, "Read") == 0) ? READ : WRITE; break;
-      case 5 : wl->offset = atoll(tmp); break;
-      case 6 : wl->size = atol(tmp); break;
-      // case 7 : wl->respone = atol(tmp); break;
-    }
-
-    /* Next */
-    tmp = strtok(NULL, ",");
-    column++;
-  }
 
-  free(tmp);
-  return 0;
+  if (cm->tn)
+    hit = tenant_run(cm, wl);
+  else if (cm->pf || cm->wb)
+    hit = run_line(cm, wl);
+  else
+    hit = cache_policy[cm->policy].run(cm, wl);
+
+  if (hit >= 0 && (wl->type == READ || wl->type == WRITE))
+    req_add(cm, wl, hit);
+  if (cm->lat)
+    lat_add(cm, wl, hit);
+  return hit;
 }/*}}}*/
 
 /**
  * cache simulator main. read worklosd and analysis..
- * @param fp : file pointer
+ * @param t : trace (csv or binary)
+ * @param cache_size : cache size (byte)
+ * @param opt : policy and parameter
+ * @param log : window stats csv output or NULL
+ * @param step : window of step request (0 is off)
+ * @param span : window of span trace tick (0 is off)
  * @return : error code
  */
-int read_workload(FILE *fp, long cache_size)
+int read_workload(struct trace *t, long cache_size, struct cache_opt *opt, FILE *log, long step,
+    unsigned long long span)
 {/*{{{*/
   int ret = 0;
-  char buf[100];
   struct cache_mem *cm = NULL;
+  struct cache_mem *base = NULL;
+  struct cache_opt bopt;
+  struct window win;
   struct workload *wl = NULL;
-
-  long tmp = -2;
-  printf("0, tmp MAX => %ld \n", MAX(0, tmp));
+  struct trace_rec *rec = NULL;
+  unsigned long long count = 0;
+  struct timespec st, et;
+  double sec = 0;
 
   /* NULL arg test */
-  if (!fp)
-    printf("arg is NULL\n");
+  if (!t || !opt) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
 
   wl = malloc(sizeof(struct workload));
   cm = init_cache_mem(cache_size / CACHE_BLOCK_SIZE);
 
+  if (!wl || !cm) {
+    ret = -2;
+    goto fail;
+  }
+  if ((ret = set_policy(cm, opt)) < 0)
+    goto fail;
+
+  /* Partition needs every tenant first */
+  if (cm->tn && (!(rec = trace_records(t, &count)) || (ret = tenant_scan(cm, rec, count)) < 0)) {
+    ret = ret < 0 ? ret : -2;
+    goto fail;
+  }
+
+  printf("%s\n", cache_policy[cm->policy].name);
   printf("%lu\n", cm->c);
   printf("%lu\n", cm->p);
 
-  if (!wl || !cm)
-    goto end;
-
-  /* read line by line */
-  while (!feof(fp)){
+  if (log)
+    win_init(&win, cm, log, step, span);
 
-    /* read line by line. saved buf */
-    if (fscanf(fp, "%s", buf) < 0)
-      goto end;
+  clock_gettime(CLOCK_MONOTONIC, &st);
 
-    /* read buf and Inscribe wl */
-    if (read_column(wl, buf) < 0)
-      goto end;
+  /* read request by request (csv line or mapped record) */
+  while ((ret = trace_next(t, wl)) == 1) {
+    if (log)
+      win_add(&win, cm, wl);
 
     /* run cache mem  */
     run_cache(cm, wl);
   }
 
-end:
+  /* Bad trace line */
+  if (ret < 0)
+    goto fail;
+
+  if (log)
+    win_end(&win, cm);
+
+  clock_gettime(CLOCK_MONOTONIC, &et);
+  sec = (et.tv_sec - st.tv_sec) + (et.tv_nsec - st.tv_nsec) / 1e9;
+
+  /* Admission on. same policy without filter on second pass */
+  if (cm->admit) {
+    trace_rewind(t);
+    bopt = *opt;
+    bopt.tlfu = 0;
+    if ((base = init_cache_mem(cm->c)) && set_policy(base, &bopt) == 0 &&
+        (!base->tn || tenant_scan(base, rec, count) >= 0)) {
+      while ((ret = trace_next(t, wl)) == 1)
+        run_cache(base, wl);
+
+      /* Bad trace line. no baseline */
+      if (ret < 0) {
+        del_cm(base);
+        goto fail;
+      }
+
+      printf("Admit : hit ratio %.3f%% (no filter %.3f%%), delta %+.3f%%\n",
+          cm->read ? 100.0 * cm->hit / cm->read : 0,
+          base->read ? 100.0 * base->hit / base->read : 0,
+          (cm->read ? 100.0 * cm->hit / cm->read : 0) -
+          (base->read ? 100.0 * base->hit / base->read : 0));
+    }
+    del_cm(base);
+  }
+
   /* reprot */
   report_cm(cm);
 
-  printf("===== Info =====\n");
-  printf("mrug %ld \n", cm->mrug.size);
-  printf("mru %ld \n", cm->mru.size);
-  printf("mfu %ld \n", cm->mfu.size);
-  printf("mfug %ld \n", cm->mfug.size);
+  if (cache_policy[cm->policy].stats)
+    cache_policy[cm->policy].stats(cm);
+  if (cm->pf)
+    prefetch_stats(cm);
+  if (cm->wb)
+    wb_stats(cm);
+  if (cm->lat)
+    lat_stats(cm);
+  if (cm->tn)
+    tenant_stats(cm);
 
   printf("===== Info =====\n");
 
   printf("read : %ld\n", cm->read);
   printf("write : %ld\n", cm->write);
   printf("HIT : %ld\n", cm->hit);
+  printf("time : %.3f sec, %.0f block/sec\n", sec,
+      sec > 0 ? (cm->read + cm->write) / sec : 0);
 
   printf("===== MRU =====\n");
   /* ARC_print(&(cm->mru.head)); */
@@ -804,9 +1011,16 @@ end:
     printf("Err\n");
 
   del_cm(cm);
+  free(wl);
   printf("END\n");
 
   return 0;
+
+fail:
+  printf("[FAIL] sim (%d), %s \n", ret, __func__);
+  del_cm(cm);
+  free(wl);
+  return ret;
 }/*}}}*/
 
 
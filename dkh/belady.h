@@ -0,0 +1,450 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  belady.h
+ *         @brief:  Belady MIN. offline optimal hit ratio. (upper bound of policies)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 19시 48분 22초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_BELADY_H
+#define __DK_BELADY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <math.h>
+#include "trace.h"
+#include "htab.h"
+
+/* Never used again */
+#define MIN_NEVER (~0ULL)
+
+/*
+ * Block access stream is same as run_cache. (request split to blocks)
+ * 1. reverse pass : next[i] = position of next access of same block.
+ *    next[] is 8 byte per block access, in unlinked temp file. ($TMPDIR)
+ *    memory is only block -> position map. (footprint)
+ * 2. forward pass : every cache size at once. resident blocks are in max
+ *    heap of next use. miss evicts furthest next use, or bypasses when
+ *    new block is used later than all of them. (MIN with bypass, upper
+ *    bound of admission filter too)
+ */
+struct min_cache
+{/*{{{*/
+  long size;                    /* cache size (byte) */
+  long c;                       /* cache size (block) */
+
+  unsigned long long *key;      /* heap. next use */
+  unsigned long long *blk;      /* heap. block */
+  long n;                       /* heap size */
+  struct htab pos;              /* block -> heap index */
+
+  long read;
+  long write;
+  long hit;
+  long bypass;
+
+  long cur;                     /* hit block of current request */
+  struct req_stat rreq, wreq;
+};/*}}}*/
+
+/**
+ * Init MIN cache.
+ * @param m : MIN cache
+ * @param size : cache size (byte)
+ * @param block : block size (byte)
+ * @return : error code
+ */
+static int min_init(struct min_cache *m, long size, long block)
+{/*{{{*/
+  memset(m, 0, sizeof(struct min_cache));
+  m->size = size;
+  m->c = size / block;
+
+  m->key = malloc(MAX(m->c, 1) * sizeof(unsigned long long));
+  m->blk = malloc(MAX(m->c, 1) * sizeof(unsigned long long));
+  if (!m->key || !m->blk || htab_init(&m->pos, m->c) < 0) {
+    free(m->key);
+    free(m->blk);
+    return -1;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Free MIN cache.
+ * @param m : MIN cache
+ */
+static void min_free(struct min_cache *m)
+{/*{{{*/
+  htab_free(&m->pos);
+  free(m->key);
+  free(m->blk);
+}/*}}}*/
+
+/**
+ * Put heap entry to index i. (update block -> index)
+ * @param m : MIN cache
+ * @param i : heap index
+ * @param key : next use
+ * @param blk : block
+ */
+static inline void min_set(struct min_cache *m, long i, unsigned long long key,
+    unsigned long long blk)
+{/*{{{*/
+  m->key[i] = key;
+  m->blk[i] = blk;
+  *htab_get(&m->pos, blk) = i;
+}/*}}}*/
+
+/**
+ * Move entry up. (key grown)
+ * @param m : MIN cache
+ * @param i : heap index
+ */
+static void min_up(struct min_cache *m, long i)
+{/*{{{*/
+  unsigned long long key = m->key[i], blk = m->blk[i];
+  long p = 0;
+
+  while (i > 0) {
+    p = (i - 1) >> 1;
+    if (m->key[p] >= key)
+      break;
+    min_set(m, i, m->key[p], m->blk[p]);
+    i = p;
+  }
+  min_set(m, i, key, blk);
+}/*}}}*/
+
+/**
+ * Move entry down. (key shrunk)
+ * @param m : MIN cache
+ * @param i : heap index
+ */
+static void min_down(struct min_cache *m, long i)
+{/*{{{*/
+  unsigned long long key = m->key[i], blk = m->blk[i];
+  long c = 0;
+
+  while ((c = 2 * i + 1) < m->n) {
+    if (c + 1 < m->n && m->key[c + 1] > m->key[c])
+      c++;
+    if (m->key[c] <= key)
+      break;
+    min_set(m, i, m->key[c], m->blk[c]);
+    i = c;
+  }
+  min_set(m, i, key, blk);
+}/*}}}*/
+
+/**
+ * Access one block.
+ * @param m : MIN cache
+ * @param blk : block
+ * @param next : next use of this access
+ * @param type : READ or WRITE
+ * @return : error code
+ */
+static inline int min_access(struct min_cache *m, unsigned long long blk,
+    unsigned long long next, int type)
+{/*{{{*/
+  unsigned long long *i = htab_get(&m->pos, blk);
+  int hit = 0;
+
+  if (i) {
+    /* Hit. key was this access, now later */
+    hit = 1;
+    m->key[*i] = next;
+    min_up(m, *i);
+  } else if (m->c > 0) {
+    if (m->n == m->c) {
+      if (m->key[0] <= next) {
+        m->bypass++;
+        goto count;
+      }
+
+      /* Evict furthest next use */
+      htab_del(&m->pos, m->blk[0]);
+      m->n--;
+      if (m->n) {
+        m->key[0] = m->key[m->n];
+        m->blk[0] = m->blk[m->n];
+        *htab_get(&m->pos, m->blk[0]) = 0;
+        min_down(m, 0);
+      }
+    }
+
+    if (!htab_put(&m->pos, blk, m->n))
+      return -2;
+    m->key[m->n] = next;
+    m->blk[m->n] = blk;
+    min_up(m, m->n++);
+  }
+
+count:
+  m->cur += hit;
+  if (type == READ) {
+    m->read++;
+    m->hit += hit;
+  } else if (type == WRITE) {
+    m->write++;
+  }
+  return 0;
+}/*}}}*/
+
+/**
+ * Number of block access of trace.
+ * @param rec : records
+ * @param count : number of records
+ * @param block : block size (byte)
+ * @return : number of block access
+ */
+static unsigned long long min_count(struct trace_rec *rec, unsigned long long count, long block)
+{/*{{{*/
+  unsigned long long i = 0, n = 0;
+
+  for (i = 0; i < count; i++)
+    n += (rec[i].offset + rec[i].size) / block - rec[i].offset / block + 1;
+  return n;
+}/*}}}*/
+
+/**
+ * Next use array in unlinked temp file. (reverse pass)
+ * @param rec : records
+ * @param count : number of records
+ * @param block : block size (byte)
+ * @param n : number of block access
+ * @return : mapped array or NULL
+ */
+static unsigned long long *min_next_use(struct trace_rec *rec, unsigned long long count,
+    long block, unsigned long long n)
+{/*{{{*/
+  char path[256];
+  char *dir = getenv("TMPDIR");
+  unsigned long long *next = NULL;
+  unsigned long long *last = NULL;
+  unsigned long long pos = n;
+  long long r = 0, b = 0, start = 0;
+  struct htab map;
+  int fd = -1;
+
+  snprintf(path, sizeof(path), "%s/dkmin.XXXXXX", dir ? dir : "/tmp");
+  if ((fd = mkstemp(path)) < 0)
+    return NULL;
+  unlink(path);
+
+  if (ftruncate(fd, MAX(n, 1) * sizeof(unsigned long long)) < 0) {
+    close(fd);
+    return NULL;
+  }
+
+  next = mmap(NULL, MAX(n, 1) * sizeof(unsigned long long), PROT_READ | PROT_WRITE,
+      MAP_SHARED, fd, 0);
+  close(fd);
+  if (next == MAP_FAILED)
+    return NULL;
+
+  if (htab_init(&map, 1 << 16) < 0)
+    goto fail;
+
+  for (r = count - 1; r >= 0; r--) {
+    start = rec[r].offset / block;
+    for (b = (rec[r].offset + rec[r].size) / block; b >= start; b--) {
+      pos--;
+      last = htab_get(&map, b);
+      next[pos] = last ? *last : MIN_NEVER;
+      if (!htab_put(&map, b, pos)) {
+        htab_free(&map);
+        goto fail;
+      }
+    }
+  }
+
+  printf("min : %llu block access, %lu blocks, next use %llu MB\n", n, map.used,
+      n * sizeof(unsigned long long) / MB);
+  htab_free(&map);
+
+  madvise(next, MAX(n, 1) * sizeof(unsigned long long), MADV_SEQUENTIAL);
+  return next;
+
+fail:
+  munmap(next, MAX(n, 1) * sizeof(unsigned long long));
+  return NULL;
+}/*}}}*/
+
+/**
+ * Ratio of min.dat index.
+ * @param e : MIN cache
+ * @param k : 0 (block), 1 (read request full hit), 2 (read byte)
+ * @return : ratio (%)
+ */
+static double min_ratio(struct min_cache *e, int k)
+{/*{{{*/
+  switch (k) {
+    case 1 : return e->rreq.req ? 100.0 * e->rreq.full / e->rreq.req : 0;
+    case 2 : return e->rreq.byte ? 100.0 * e->rreq.hit_byte / e->rreq.byte : 0;
+  }
+  return e->read ? 100.0 * e->hit / e->read : 0;
+}/*}}}*/
+
+/**
+ * Print MIN result. table and min.dat (gnu/result_min, gnu/result_request)
+ * min.dat index 0 : block hit ratio (same as sweep)
+ *         index 1 : read request full hit ratio
+ *         index 2 : read byte hit ratio
+ * @param m : MIN cache array. (size x block)
+ * @param nsize : number of cache size
+ * @param block : block size array (byte)
+ * @param nblock : number of block size
+ * @param out : min.dat output or NULL
+ */
+static void min_report(struct min_cache *m, int nsize, long *block, int nblock, FILE *out)
+{/*{{{*/
+  static char *name[] = {"", "req-", "byte-"};
+  struct min_cache *e = NULL;
+  int i = 0, j = 0, k = 0;
+
+  printf("========== min ==========\n");
+  printf("%10s %6s %12s %12s %8s %12s %12s %8s %8s\n", "size(MB)", "block", "hit", "read",
+      "ratio", "write", "bypass", "r_full", "r_byte");
+  for (i = 0; i < nsize; i++) {
+    for (j = 0; j < nblock; j++) {
+      e = &m[j * nsize + i];
+      printf("%10ld %5ldK %12ld %12ld %8.3f %12ld %12ld %8.3f %8.3f\n", e->size / MB,
+          block[j] / KB, e->hit, e->read, e->read ? 100.0 * e->hit / e->read : 0, e->write,
+          e->bypass, e->rreq.req ? 100.0 * e->rreq.full / e->rreq.req : 0,
+          e->rreq.byte ? 100.0 * e->rreq.hit_byte / e->rreq.byte : 0);
+    }
+  }
+  printf("========== min ==========\n");
+
+  if (!out)
+    return;
+
+  /* row : log2(size), column : block size. (same as sweep) */
+  for (k = 0; k < 3; k++) {
+    fprintf(out, k ? "\n\nSize" : "Size");
+    for (j = 0; j < nblock; j++)
+      fprintf(out, "  MIN-%s%ldK", name[k], block[j] / KB);
+    fprintf(out, "\n");
+
+    for (i = 0; i < nsize; i++) {
+      fprintf(out, "%g", log2(m[i].size));
+      for (j = 0; j < nblock; j++) {
+        e = &m[j * nsize + i];
+        fprintf(out, "  %.3f", min_ratio(e, k));
+      }
+      fprintf(out, "\n");
+    }
+  }
+}/*}}}*/
+
+/**
+ * MIN main. one reverse pass and one forward pass per block size.
+ * Records of .bin trace are mapped. csv trace is parsed into memory first
+ * (trace_records), so large csv should be converted. (-m convert)
+ * @param t : trace
+ * @param size : cache size array (byte)
+ * @param nsize : number of cache size
+ * @param block : block size array (byte)
+ * @param nblock : number of block size
+ * @param out : min.dat output or NULL
+ * @return : error code
+ */
+int run_min(struct trace *t, long *size, int nsize, long *block, int nblock, FILE *out)
+{/*{{{*/
+  struct trace_rec *rec = NULL;
+  struct min_cache *m = NULL;
+  struct min_cache *e = NULL;
+  struct workload wl;
+  unsigned long long count = 0, n = 0, pos = 0, r = 0;
+  unsigned long long *next = NULL;
+  long long b = 0, end = 0;
+  int i = 0, j = 0, ninit = 0, ret = 0;
+
+  /* NULL arg */
+  if (!t || !size || !block || nsize <= 0 || nblock <= 0) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(rec = trace_records(t, &count)))
+    return -2;
+
+  if (!(m = calloc(nsize * nblock, sizeof(struct min_cache))))
+    return -2;
+
+  for (j = 0; j < nblock; j++) {
+    n = min_count(rec, count, block[j]);
+    if (!(next = min_next_use(rec, count, block[j], n))) {
+      ret = -3;
+      goto end;
+    }
+
+    for (i = 0; i < nsize; i++, ninit++) {
+      if (min_init(&m[j * nsize + i], size[i], block[j]) < 0) {
+        ret = -2;
+        goto unmap;
+      }
+    }
+
+    /* Forward pass. every size reads same next use */
+    for (r = 0, pos = 0; r < count; r++) {
+      trace_rec_load(&rec[r], &wl);
+      end = (rec[r].offset + rec[r].size) / block[j];
+      for (b = rec[r].offset / block[j]; b <= end; b++, pos++) {
+        for (i = 0; i < nsize; i++) {
+          e = &m[j * nsize + i];
+          if (min_access(e, b, next[pos], rec[r].type) < 0) {
+            ret = -2;
+            goto unmap;
+          }
+        }
+      }
+
+      /* Request level of every size */
+      for (i = 0; i < nsize; i++) {
+        e = &m[j * nsize + i];
+        if (wl.type == READ || wl.type == WRITE)
+          req_count(wl.type == READ ? &e->rreq : &e->wreq, &wl, block[j], e->cur);
+        e->cur = 0;
+      }
+    }
+
+    /* Heap is not needed for report */
+    for (i = 0; i < nsize; i++) {
+      e = &m[j * nsize + i];
+      min_free(e);
+      e->key = e->blk = NULL;
+    }
+
+    munmap(next, MAX(n, 1) * sizeof(unsigned long long));
+  }
+
+  min_report(m, nsize, block, nblock, out);
+  goto end;
+
+unmap:
+  munmap(next, MAX(n, 1) * sizeof(unsigned long long));
+end:
+  for (i = 0; i < ninit; i++)
+    min_free(&m[i]);
+  free(m);
+
+  return ret;
+}/*}}}*/
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  car.c
+ *         @brief:  CAR. (Clock with Adaptive Replacement, Bansal & Modha, FAST 04)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 16시 03분 19초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+/*
+ * CAR uses cache_mem of ARC as is.
+ *   T1 = mru, T2 = mfu : clock. hand is LRU end (ARC_state_lru),
+ *                        new line is put just behind hand (list head).
+ *   B1 = mrug, B2 = mfug : ghost LRU list.
+ * Hit only sets reference bit. Lines move only on miss.
+ */
+
+static void CAR_replace(struct cache_mem *cm);
+struct cache_line *CAR_cache(struct cache_mem *cm, long long line);
+
+/**
+ * Move hand until unreferenced line is found, and demote it to ghost.
+ * Referenced line of T1 goes to T2, of T2 goes to tail of T2.
+ * @param cm : cache memory. (T1 + T2 == c)
+ */
+static void CAR_replace(struct cache_mem *cm)
+{/*{{{*/
+  struct cache_line *l = NULL;
+
+  while (1) {
+    if (cm->mru.size >= MAX(1, cm->p)) {
+      l = ARC_state_lru(&cm->mru);
+      if (!l->ref) {
+        line_move(cm, l, &cm->mrug);
+        return;
+      }
+      l->ref = 0;
+      line_move(cm, l, &cm->mfu);
+    } else {
+      l = ARC_state_lru(&cm->mfu);
+      if (!l->ref) {
+        line_move(cm, l, &cm->mfug);
+        return;
+      }
+      l->ref = 0;
+      line_move(cm, l, &cm->mfu);
+    }
+  }
+}/*}}}*/
+
+/**
+ * CAR Main function.
+ * @param cm : cache memory.
+ * @param line : line
+ * @return : line (hit in T1, T2) or NULL (miss, ghost hit)
+ */
+struct cache_line *CAR_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+
+  /* Hit. set reference bit only */
+  if (l && (l->state == &cm->mru || l->state == &cm->mfu)) {
+    l->ref = 1;
+    return l;
+  }
+
+  if (cm->c <= 0)
+    return NULL;
+
+  /* Cache full. replace a page, then keep directory <= 2c */
+  if (cm->mru.size + cm->mfu.size >= cm->c) {
+    CAR_replace(cm);
+
+    if (!l) {
+      if (cm->mru.size + cm->mrug.size >= cm->c && cm->mrug.size)
+        line_move(cm, ARC_state_lru(&cm->mrug), NULL);
+      else if (cm->mru.size + cm->mfu.size + cm->mrug.size + cm->mfug.size >= 2 * cm->c &&
+          cm->mfug.size)
+        line_move(cm, ARC_state_lru(&cm->mfug), NULL);
+    }
+  }
+
+  if (!l) {
+    /* New line. tail of T1 */
+    if (!(l = create_line(cm, line)))
+      return NULL;
+
+    hash_insert(cm, l);
+    line_move(cm, l, &cm->mru);
+  } else if (l->state == &cm->mrug) {
+    /* B1 hit. T1 target grows */
+    cm->p = MIN(cm->p + MAX(1, cm->mfug.size / cm->mrug.size), cm->c);
+    cm->b1_hit++;
+    l->ref = 0;
+    line_move(cm, l, &cm->mfu);
+  } else {
+    /* B2 hit. T1 target shrinks */
+    cm->p = MAX(cm->p - MAX(1, cm->mrug.size / cm->mfug.size), 0);
+    cm->b2_hit++;
+    l->ref = 0;
+    line_move(cm, l, &cm->mfu);
+  }
+
+  return NULL;
+}/*}}}*/
@@ -0,0 +1,285 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  clockpro.c
+ *         @brief:  CLOCK-Pro. (Jiang, Chen & Zhang, USENIX ATC 05)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 18시 14분 37초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+/*
+ * CLOCK-Pro uses cache_mem of ARC.
+ * Every line (hot, cold, test) is in one ring linked by l.head. (no list head)
+ * l.state is type only, state list is empty and state size is count.
+ *   hot = mru, cold = mfu : resident
+ *   test = mrug : non-resident cold in test period
+ * Cold line in test period has LINE_TEST. (resident or not)
+ * cm->p is target of cold. (mem_cold, CLOCKPRO_MIN ~ c - CLOCKPRO_MIN)
+ * Hit only sets reference bit.
+ * New line is put just behind hand_hot. Hands move forward one by one and
+ * never call each other, each hand loop stops when its work is done.
+ */
+
+/* Bound of cold target. 1% of cache like paper */
+#define CLOCKPRO_MIN(c) MAX((c) / 100, 1)
+
+/**
+ * Change type of line.
+ * @param l : line
+ * @param state : hot, cold, test
+ */
+static inline void CLOCKPRO_type(struct cache_line *l, struct cache_state *state)
+{/*{{{*/
+  l->state->size--;
+  l->state = state;
+  state->size++;
+}/*}}}*/
+
+/**
+ * Put line into ring. (just behind hand_hot)
+ * @param cm : cache memory.
+ * @param l : line (not in ring)
+ */
+static inline void CLOCKPRO_link(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  if (!cm->hand_hot) {
+    init_list(&l->head);
+    cm->hand_hot = cm->hand_cold = cm->hand_test = &l->head;
+    return;
+  }
+
+  list_insert(&l->head, cm->hand_hot->prev, cm->hand_hot);
+}/*}}}*/
+
+/**
+ * Take line out of ring. hand on line goes back one.
+ * @param cm : cache memory.
+ * @param l : line
+ */
+static inline void CLOCKPRO_unlink(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  /* Last line */
+  if (l->head.next == &l->head) {
+    cm->hand_hot = cm->hand_cold = cm->hand_test = NULL;
+    return;
+  }
+
+  if (cm->hand_hot == &l->head)
+    cm->hand_hot = l->head.prev;
+  if (cm->hand_cold == &l->head)
+    cm->hand_cold = l->head.prev;
+  if (cm->hand_test == &l->head)
+    cm->hand_test = l->head.prev;
+
+  list_remove(&l->head);
+}/*}}}*/
+
+/**
+ * Move line to head of ring. (just behind hand_hot)
+ * @param cm : cache memory.
+ * @param l : line in ring
+ */
+static inline void CLOCKPRO_head(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  /* Already just behind hand_hot after hand moves on */
+  if (cm->hand_hot == &l->head) {
+    cm->hand_hot = l->head.next;
+    return;
+  }
+
+  CLOCKPRO_unlink(cm, l);
+  CLOCKPRO_link(cm, l);
+}/*}}}*/
+
+/**
+ * Remove line from ring and free it.
+ * @param cm : cache memory.
+ * @param l : line (cold or test)
+ */
+static void CLOCKPRO_remove(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  CLOCKPRO_unlink(cm, l);
+  l->state->size--;
+  list_remove(&l->hash);
+  slab_free(&cm->slab, l);
+}/*}}}*/
+
+/**
+ * Resident line leaves cache.
+ * @param cm : cache memory.
+ * @param l : line
+ */
+static inline void CLOCKPRO_evict(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  cm->evicted++;
+  if (cm->evict)
+    cm->evict(cm, l);
+  if (l->data && cm->release)
+    cm->release(l->data);
+  l->data = NULL;
+}/*}}}*/
+
+/**
+ * Test period of cold line is over without reuse. cold target shrinks.
+ * @param cm : cache memory.
+ * @param l : cold line in test period
+ */
+static void CLOCKPRO_test_end(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  l->flag &= ~LINE_TEST;
+  if (cm->p > CLOCKPRO_MIN(cm->c))
+    cm->p--;
+
+  if (l->state == &cm->mrug)
+    CLOCKPRO_remove(cm, l);
+}/*}}}*/
+
+/**
+ * hand_test. end test period until test line is c or less.
+ * @param cm : cache memory.
+ */
+static void CLOCKPRO_hand_test(struct cache_mem *cm)
+{/*{{{*/
+  struct cache_line *l = NULL;
+
+  while (cm->mrug.size > cm->c) {
+    l = list_entry(cm->hand_test, struct cache_line, head);
+    cm->hand_test = cm->hand_test->next;
+
+    if (l->flag & LINE_TEST)
+      CLOCKPRO_test_end(cm, l);
+  }
+}/*}}}*/
+
+/**
+ * hand_hot. unreferenced hot becomes cold until hot is max or less.
+ * Test period of cold line it passes is over. (same as hand_test)
+ * @param cm : cache memory.
+ * @param max : hot line. (c - p is target)
+ */
+static void CLOCKPRO_hand_hot(struct cache_mem *cm, long max)
+{/*{{{*/
+  struct cache_line *l = NULL;
+
+  while (cm->mru.size > max) {
+    l = list_entry(cm->hand_hot, struct cache_line, head);
+    cm->hand_hot = cm->hand_hot->next;
+
+    if (l->state == &cm->mru) {
+      if (l->ref)
+        l->ref = 0;
+      else
+        CLOCKPRO_type(l, &cm->mfu);
+    } else if (l->flag & LINE_TEST) {
+      CLOCKPRO_test_end(cm, l);
+    }
+  }
+}/*}}}*/
+
+/**
+ * hand_cold. runs until one resident cold line leaves cache.
+ *   ref, in test     : reuse distance is under hot, becomes hot
+ *   ref, not test    : new test period, to head
+ *   no ref, in test  : leaves cache, stays as test line
+ *   no ref, not test : removed
+ * @param cm : cache memory.
+ */
+static void CLOCKPRO_hand_cold(struct cache_mem *cm)
+{/*{{{*/
+  struct cache_line *l = NULL;
+
+  for (;;) {
+    /* Every resident line is hot. one goes cold */
+    if (!cm->mfu.size)
+      CLOCKPRO_hand_hot(cm, cm->mru.size - 1);
+
+    l = list_entry(cm->hand_cold, struct cache_line, head);
+    cm->hand_cold = cm->hand_cold->next;
+    if (l->state != &cm->mfu)
+      continue;
+
+    if (l->ref) {
+      l->ref = 0;
+      if (l->flag & LINE_TEST) {
+        l->flag &= ~LINE_TEST;
+        CLOCKPRO_type(l, &cm->mru);
+        CLOCKPRO_head(cm, l);
+        CLOCKPRO_hand_hot(cm, cm->c - cm->p);
+      } else {
+        l->flag |= LINE_TEST;
+        CLOCKPRO_head(cm, l);
+      }
+      continue;
+    }
+
+    CLOCKPRO_evict(cm, l);
+    if (l->flag & LINE_TEST) {
+      CLOCKPRO_type(l, &cm->mrug);
+      CLOCKPRO_hand_test(cm);
+    } else {
+      CLOCKPRO_remove(cm, l);
+    }
+    return;
+  }
+}/*}}}*/
+
+/**
+ * CLOCK-Pro Main function.
+ * @param cm : cache memory.
+ * @param line : line
+ * @return : line (hit in hot, cold) or NULL (miss, test hit)
+ */
+struct cache_line *CLOCKPRO_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+
+  /* Hit. set reference bit only */
+  if (l && (l->state == &cm->mru || l->state == &cm->mfu)) {
+    l->ref = 1;
+    return l;
+  }
+
+  if (cm->c <= 0)
+    return NULL;
+
+  if (l) {
+    /* Test hit. small reuse distance, cold target grows */
+    if (cm->p < cm->c - CLOCKPRO_MIN(cm->c))
+      cm->p++;
+    CLOCKPRO_unlink(cm, l);
+    l->state->size--;
+    cm->b1_hit++;
+  }
+
+  /* Make room. (line is out of ring) */
+  while (cm->mru.size + cm->mfu.size >= cm->c)
+    CLOCKPRO_hand_cold(cm);
+
+  if (l) {
+    /* comes back hot */
+    l->state = &cm->mru;
+    l->flag &= ~LINE_TEST;
+  } else {
+    if (!(l = create_line(cm, line)))
+      return NULL;
+
+    hash_insert(cm, l);
+    l->state = &cm->mfu;
+    l->flag |= LINE_TEST;
+  }
+
+  l->state->size++;
+  l->ref = 0;
+  CLOCKPRO_link(cm, l);
+
+  if (l->state == &cm->mru)
+    CLOCKPRO_hand_hot(cm, cm->c - cm->p);
+  return NULL;
+}/*}}}*/
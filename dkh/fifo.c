@@ -0,0 +1,327 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  fifo.c
+ *         @brief:  S3-FIFO and SIEVE on array ring. (no list_head, no reorder on hit)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 18시 41분 26초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+/*
+ * Ring slot is one u64. (line << 2 | 2 bit counter)
+ * Ring position is monotonic, slot is position & mask.
+ * htab maps line to (queue << 60 | position).
+ *
+ * S3-FIFO (Yang et al., SOSP 23)
+ *   S : small FIFO (small * c). line hit in S is moved to M, else goes to G.
+ *   M : main FIFO. line with counter is put back with counter - 1.
+ *   G : ghost FIFO of line. (|M| max) line hit in G is put into M.
+ * SIEVE (Zhang et al., NSDI 24)
+ *   One FIFO log. (2c slot) hand goes from old to new, clears visited bit and
+ *   evicts first unvisited line. evicted slot is a hole (FIFO_HOLE), holes
+ *   are squeezed out when log is full.
+ */
+
+#define FIFO_S 1ULL
+#define FIFO_M 2ULL
+#define FIFO_G 3ULL
+
+#define FIFO_POS_MASK ((1ULL << 60) - 1)
+#define FIFO_VAL(q, pos) ((q) << 60 | (pos))
+#define FIFO_HOLE (~0ULL)
+
+/* Max S3-FIFO counter */
+#define FIFO_FREQ_MAX 3
+
+struct fifo_ring
+{/*{{{*/
+  unsigned long long *slot;
+  unsigned long long mask;  /* 2^n - 1 */
+  unsigned long long head;  /* next push position */
+  unsigned long long tail;  /* oldest position */
+};/*}}}*/
+
+struct fifo
+{/*{{{*/
+  struct htab map;          /* line -> queue, position */
+  struct fifo_ring s, m, g; /* SIEVE uses s only */
+
+  /* same type as ring counter */
+  unsigned long long small_max;
+  unsigned long long main_max;
+  unsigned long long ghost_max;
+  unsigned int move;        /* S -> M counter */
+
+  unsigned long long hand;  /* SIEVE hand position */
+  long live;                /* SIEVE resident */
+
+  long ghost_hit;
+  long squeeze;
+  long evict;               /* resident line dropped */
+};/*}}}*/
+
+int S3FIFO_cache(struct cache_mem *cm, long long line);
+int SIEVE_cache(struct cache_mem *cm, long long line);
+
+/**
+ * Init ring.
+ * @param r : ring
+ * @param n : number of slot (round up to 2^n)
+ * @return : error code
+ */
+static int fifo_ring_init(struct fifo_ring *r, unsigned long n)
+{/*{{{*/
+  memset(r, 0, sizeof(struct fifo_ring));
+  r->mask = (1ULL << hash_bits(MAX(n, 1))) - 1;
+  if (!(r->slot = malloc((r->mask + 1) * sizeof(unsigned long long))))
+    return -1;
+  return 0;
+}/*}}}*/
+
+/**
+ * Slot of position.
+ * @param r : ring
+ * @param pos : position
+ * @return : slot
+ */
+static inline unsigned long long *fifo_at(struct fifo_ring *r, unsigned long long pos)
+{/*{{{*/
+  return &r->slot[pos & r->mask];
+}/*}}}*/
+
+/**
+ * Push to head.
+ * @param r : ring (not full)
+ * @param v : slot value
+ * @return : position
+ */
+static inline unsigned long long fifo_push(struct fifo_ring *r, unsigned long long v)
+{/*{{{*/
+  *fifo_at(r, r->head) = v;
+  return r->head++;
+}/*}}}*/
+
+/**
+ * Free fifo. (cache_mem.priv_free)
+ * @param priv : fifo
+ */
+static void fifo_free(void *priv)
+{/*{{{*/
+  struct fifo *f = priv;
+
+  if (!f)
+    return;
+
+  htab_free(&f->map);
+  free(f->s.slot);
+  free(f->m.slot);
+  free(f->g.slot);
+  free(f);
+}/*}}}*/
+
+/**
+ * Put line into G. oldest ghost is forgotten when G is full.
+ * Slot of line hit in G later is stale. (map points other queue)
+ * @param f : fifo
+ * @param line : line
+ */
+static inline void S3FIFO_ghost(struct fifo *f, unsigned long long line)
+{/*{{{*/
+  unsigned long long *v = NULL;
+  unsigned long long old = 0;
+
+  if (!f->ghost_max) {
+    htab_del(&f->map, line);
+    return;
+  }
+
+  if (f->g.head - f->g.tail >= f->ghost_max) {
+    old = *fifo_at(&f->g, f->g.tail);
+    v = htab_get(&f->map, old);
+    if (v && *v == FIFO_VAL(FIFO_G, f->g.tail))
+      htab_del(&f->map, old);
+    f->g.tail++;
+  }
+
+  htab_put(&f->map, line, FIFO_VAL(FIFO_G, fifo_push(&f->g, line)));
+}/*}}}*/
+
+/**
+ * Evict one line from M. line with counter goes back to head.
+ * @param f : fifo
+ */
+static void S3FIFO_evict_m(struct fifo *f)
+{/*{{{*/
+  unsigned long long v = 0;
+
+  while (f->m.head != f->m.tail) {
+    v = *fifo_at(&f->m, f->m.tail++);
+    if (v & 3) {
+      htab_put(&f->map, v >> 2, FIFO_VAL(FIFO_M, fifo_push(&f->m, v - 1)));
+      continue;
+    }
+
+    htab_del(&f->map, v >> 2);
+    f->evict++;
+    return;
+  }
+}/*}}}*/
+
+/**
+ * Evict one line from S. line hit in S is moved to M (not evicted).
+ * @param f : fifo
+ */
+static void S3FIFO_evict_s(struct fifo *f)
+{/*{{{*/
+  unsigned long long v = 0;
+
+  while (f->s.head != f->s.tail) {
+    v = *fifo_at(&f->s, f->s.tail++);
+    if ((v & 3) >= f->move) {
+      htab_put(&f->map, v >> 2, FIFO_VAL(FIFO_M, fifo_push(&f->m, v & ~3ULL)));
+      if (f->m.head - f->m.tail > f->main_max)
+        S3FIFO_evict_m(f);
+      continue;
+    }
+
+    S3FIFO_ghost(f, v >> 2);
+    f->evict++;
+    return;
+  }
+}/*}}}*/
+
+/**
+ * S3-FIFO Main function.
+ * @param cm : cache memory. (priv is fifo)
+ * @param line : line
+ * @return : 1 (hit), 0 (miss)
+ */
+int S3FIFO_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct fifo *f = cm->priv;
+  unsigned long long *v = htab_get(&f->map, line);
+  unsigned long long *slot = NULL;
+  unsigned long long q = v ? *v >> 60 : 0;
+
+  /* Hit. counter only */
+  if (q == FIFO_S || q == FIFO_M) {
+    slot = fifo_at(q == FIFO_S ? &f->s : &f->m, *v & FIFO_POS_MASK);
+    if ((*slot & 3) < FIFO_FREQ_MAX)
+      (*slot)++;
+    return 1;
+  }
+
+  if (cm->c <= 0)
+    return 0;
+
+  if (q == FIFO_G)
+    f->ghost_hit++;
+
+  /* Full. evict from S if S is over its size */
+  if ((long)(f->s.head - f->s.tail + f->m.head - f->m.tail) >= cm->c) {
+    if (f->s.head - f->s.tail >= f->small_max || f->m.head == f->m.tail)
+      S3FIFO_evict_s(f);
+    else
+      S3FIFO_evict_m(f);
+  }
+
+  if (q == FIFO_G)
+    htab_put(&f->map, line, FIFO_VAL(FIFO_M, fifo_push(&f->m, (unsigned long long)line << 2)));
+  else
+    htab_put(&f->map, line, FIFO_VAL(FIFO_S, fifo_push(&f->s, (unsigned long long)line << 2)));
+  return 0;
+}/*}}}*/
+
+/**
+ * Squeeze holes out of SIEVE log. order and hand are kept.
+ * @param f : fifo
+ */
+static void SIEVE_squeeze(struct fifo *f)
+{/*{{{*/
+  unsigned long long r = 0, w = f->s.tail, hand = 0;
+  unsigned long long v = 0;
+  int found = 0;
+
+  for (r = f->s.tail; r < f->s.head; r++) {
+    if (r == f->hand) {
+      hand = w;
+      found = 1;
+    }
+
+    v = *fifo_at(&f->s, r);
+    if (v == FIFO_HOLE)
+      continue;
+
+    if (w != r) {
+      *fifo_at(&f->s, w) = v;
+      *htab_get(&f->map, v >> 2) = w;
+    }
+    w++;
+  }
+
+  f->s.head = w;
+  f->hand = found ? hand : f->s.tail;
+  f->squeeze++;
+}/*}}}*/
+
+/**
+ * SIEVE Main function.
+ * @param cm : cache memory. (priv is fifo)
+ * @param line : line
+ * @return : 1 (hit), 0 (miss)
+ */
+int SIEVE_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct fifo *f = cm->priv;
+  unsigned long long *v = htab_get(&f->map, line);
+  unsigned long long *slot = NULL;
+
+  /* Hit. visited bit only */
+  if (v) {
+    *fifo_at(&f->s, *v) |= 1;
+    return 1;
+  }
+
+  if (cm->c <= 0)
+    return 0;
+
+  /* Full. hand evicts first unvisited line */
+  if (f->live >= cm->c) {
+    while (1) {
+      if (f->hand >= f->s.head || f->hand < f->s.tail)
+        f->hand = f->s.tail;
+
+      slot = fifo_at(&f->s, f->hand++);
+      if (*slot == FIFO_HOLE)
+        continue;
+
+      if (*slot & 1) {
+        *slot &= ~1ULL;
+        continue;
+      }
+
+      htab_del(&f->map, *slot >> 2);
+      *slot = FIFO_HOLE;
+      f->live--;
+      f->evict++;
+      break;
+    }
+
+    while (f->s.tail < f->s.head && *fifo_at(&f->s, f->s.tail) == FIFO_HOLE)
+      f->s.tail++;
+  }
+
+  if (f->s.head - f->s.tail > f->s.mask)
+    SIEVE_squeeze(f);
+
+  htab_put(&f->map, line, fifo_push(&f->s, (unsigned long long)line << 2));
+  f->live++;
+  return 0;
+}/*}}}*/
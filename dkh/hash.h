@@ -16,83 +16,58 @@
  * =====================================================================================
  */
 
+#ifndef __DK_HASH_H
+#define __DK_HASH_H
+
 #ifdef dk_list
 #else
 #include "dk_list.h"
 #endif
 
 #define GOLDEN_RATIO_PRIME_32 0x9e370001UL
+#define GOLDEN_RATIO_64 0x61C8864680B583EBULL
 
-static __always_inline unsigned int hash_64(unsigned int val, unsigned int bits)
+/**
+ * Multiplicative hash. (Fibonacci hashing)
+ * @param val : 64bit key (block number)
+ * @param bits : hash bits. table size is 2^bits (1 ~ 64)
+ * @return : 0 ~ 2^bits - 1
+ */
+static __always_inline unsigned long hash_64(unsigned long long val, unsigned int bits)
 {/*{{{*/
-  unsigned int hash = val;
-
-  /*   Sigh, gcc can't optimise this alone like it does for 32 bits. */
-  unsigned int n = hash;
-  n <<= 18;
-  hash -= n;
-  n <<= 31;
-  hash -= n;
-  n <<= 3;
-  hash += n;
-  n <<= 3;
-  hash -= n;
-  n <<= 4;
-  hash += n;
-  n <<= 2;
-  hash += n;
-
   /*  High bits are more random, so use them. */
-  return hash >> (64 - bits);
+  return (unsigned long)((val * GOLDEN_RATIO_64) >> (64 - bits));
 }/*}}}*/
- 
-struct hash_row
-{
-  void *p;
-  struct list_head head;
-};
-
-struct hash_table
-{
-  int len;
-  struct hash_row *row;
-};
-
-int add_hash_table(struct hash_table *ht, unsigned int val)
-{
-  struct hash_row *rr = NULL;
-
-  rr = ht->row;
-
-  hash_64(val, 32);
-
-  return 0;
-}
-
-int lookup_hash(struct hash_table *ht)
-{
-  struct hash_row *rr = NULL;
-
-  rr = ht->row;
-  printf("%d\n", rr[0]);
 
-  return 0;
-}
-
-struct hash_table *init_hash(int len)
-{
-  struct hash_table *ret = NULL;
-
-  if (len < 0)
-    return NULL;
-
-  ret = malloc(sizeof(struct hash_table));
-  ret->len = len;
-  ret->row = malloc(sizeof(struct hash_row) * len);
+/**
+ * Full avalanche mix of 64bit key. (murmur3 fmix64)
+ * Every input bit affects every output bit. use when low bits are needed
+ * or keys are multiple of large power of 2.
+ * @param val : 64bit key
+ * @return : mixed key
+ */
+static __always_inline unsigned long long mix_64(unsigned long long val)
+{/*{{{*/
+  val ^= val >> 33;
+  val *= 0xff51afd7ed558ccdULL;
+  val ^= val >> 33;
+  val *= 0xc4ceb9fe1a85ec53ULL;
+  val ^= val >> 33;
+  return val;
+}/*}}}*/
 
-  memset(ret->row, sizeof(struct hash_row) * len, '\0');
-  return ret;
+/**
+ * Hash bits of table. (smallest 2^bits >= n)
+ * @param n : number of entry
+ * @return : bits
+ */
+static inline unsigned int hash_bits(unsigned long long n)
+{/*{{{*/
+  unsigned int bits = 1;
 
+  while ((1ULL << bits) < n && bits < 63)
+    bits++;
+  return bits;
+}/*}}}*/
 
-  return 0;
-}
+#endif
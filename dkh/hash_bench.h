@@ -0,0 +1,240 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  hash_bench.h
+ *         @brief:  Hash function quality / throughput on trace block numbers.
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 13시 05분 31초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_HASH_BENCH_H
+#define __DK_HASH_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "trace.h"
+#include "hash.h"
+#include "htab.h"
+
+/* Max block access kept for bench */
+#define HASH_BENCH_MAX_KEY (1 << 24)
+
+/* Chain length histogram. (0 ~ 7, 8+) */
+#define HASH_BENCH_CHAIN 9
+
+/* Throughput loop repeat */
+#define HASH_BENCH_ROUND 8
+
+/*
+ * Candidate : bucket number of key in 2^bits table.
+ * hb_run_##name hashes every key. (candidate is inlined, no call cost)
+ */
+#define HASH_BENCH_FUNC(name, expr) \
+  static __always_inline unsigned long hb_##name(unsigned long long key, unsigned int bits) \
+  { return (expr); } \
+  static unsigned long long hb_run_##name(unsigned long long *key, long n, unsigned int bits) \
+  { \
+    unsigned long long sum = 0; \
+    long i = 0; \
+    for (i = 0; i < n; i++) \
+      sum += hb_##name(key[i], bits); \
+    return sum; \
+  }
+
+/**
+ * Old ARC hash. sprintf line % size, then fold string.
+ * @param key : block number
+ * @param bits : hash bits
+ * @return : bucket number
+ */
+static inline unsigned long hb_string(unsigned long long key, unsigned int bits)
+{/*{{{*/
+  char str[33];
+  unsigned long ret = 0;
+  int i = 0;
+  unsigned long size = 1UL << bits;
+
+  sprintf(str, "%lld", key % size);
+  while (str[i]) {
+    ret += str[i++];
+    ret <<= 4;
+  }
+  return ret % size;
+}/*}}}*/
+
+HASH_BENCH_FUNC(str, hb_string(key, bits))
+HASH_BENCH_FUNC(mod, key & ((1UL << bits) - 1))
+HASH_BENCH_FUNC(gr32, (unsigned int)((unsigned int)key * GOLDEN_RATIO_PRIME_32) >> (32 - bits))
+HASH_BENCH_FUNC(hash_64, hash_64(key, bits))
+HASH_BENCH_FUNC(mix_64, mix_64(key) & ((1UL << bits) - 1))
+
+struct hash_func
+{/*{{{*/
+  char *name;
+  unsigned long (*fn)(unsigned long long key, unsigned int bits);
+  unsigned long long (*run)(unsigned long long *key, long n, unsigned int bits);
+};/*}}}*/
+
+static struct hash_func hash_func[] = {
+  {"string", hb_str, hb_run_str},
+  {"mod", hb_mod, hb_run_mod},
+  {"gr32", hb_gr32, hb_run_gr32},
+  {"hash_64", hb_hash_64, hb_run_hash_64},
+  {"mix_64", hb_mix_64, hb_run_mix_64},
+};
+
+/**
+ * Now (ns).
+ * @return : monotonic time
+ */
+static inline double now_ns(void)
+{/*{{{*/
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}/*}}}*/
+
+/**
+ * Bench one hash function.
+ * @param f : hash function
+ * @param access : block access stream (throughput)
+ * @param na : number of access
+ * @param key : distinct block (chain length)
+ * @param nk : number of distinct block
+ * @param bits : table size 2^bits
+ * @return : error code
+ */
+static int hash_bench_one(struct hash_func *f, unsigned long long *access, long na,
+    unsigned long long *key, unsigned long nk, unsigned int bits)
+{/*{{{*/
+  unsigned int *chain = NULL;
+  unsigned long long hist[HASH_BENCH_CHAIN] = {0, };
+  unsigned long long sum = 0, probe = 0;
+  unsigned long size = 1UL << bits;
+  unsigned long i = 0, used = 0, max = 0;
+  double t = 0;
+  int r = 0, round = HASH_BENCH_ROUND;
+
+  if (!(chain = calloc(size, sizeof(unsigned int))))
+    return -1;
+
+  /* string hash is slow. 1 round */
+  if (f->run == hb_run_str)
+    round = 1;
+
+  t = now_ns();
+  for (r = 0; r < round; r++)
+    sum += f->run(access, na, bits);
+  t = (now_ns() - t) / ((double)na * round);
+
+  for (i = 0; i < nk; i++)
+    chain[f->fn(key[i], bits)]++;
+
+  /* probe : compare count of lookup hit. (1 + 2 + .. + len) */
+  for (i = 0; i < size; i++) {
+    if (chain[i])
+      used++;
+    max = MAX(max, chain[i]);
+    probe += (unsigned long long)chain[i] * (chain[i] + 1) / 2;
+    hist[MIN(chain[i], HASH_BENCH_CHAIN - 1)]++;
+  }
+
+  printf("%-8s %7.2f %7.2f %5lu %6.3f", f->name, t, 100.0 * used / size, max,
+      nk ? (double)probe / nk : 0);
+  for (r = 0; r < HASH_BENCH_CHAIN; r++)
+    printf(" %6.2f", 100.0 * hist[r] / size);
+  printf("  (%llx)\n", sum & 0xf);
+
+  free(chain);
+  return 0;
+}/*}}}*/
+
+/**
+ * Hash bench main. key is block number of trace.
+ * @param t : trace
+ * @param cache_size : table size (byte), 0 is number of distinct block
+ * @return : error code
+ */
+int run_hash_bench(struct trace *t, long cache_size)
+{/*{{{*/
+  unsigned long long *access = NULL;
+  unsigned long long *key = NULL;
+  struct htab seen;
+  struct workload wl;
+  long na = 0, nk = 0, i = 0;
+  long long start = 0, end = 0;
+  unsigned int bits = 0;
+  int ret = 0;
+
+  /* NULL arg */
+  if (!t) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  access = malloc(HASH_BENCH_MAX_KEY * sizeof(unsigned long long));
+  key = malloc(HASH_BENCH_MAX_KEY * sizeof(unsigned long long));
+  if (!access || !key || htab_init(&seen, 1 << 16) < 0) {
+    free(access);
+    free(key);
+    return -2;
+  }
+
+  /* Block stream. (same split as run_cache) */
+  while (na < HASH_BENCH_MAX_KEY && (ret = trace_next(t, &wl)) == 1) {
+    start = wl.offset / CACHE_BLOCK_SIZE;
+    end = (wl.offset + wl.size) / CACHE_BLOCK_SIZE;
+
+    for (i = start; i <= end && na < HASH_BENCH_MAX_KEY; i++) {
+      access[na++] = i;
+      if (!htab_get(&seen, i)) {
+        if (!htab_put(&seen, i, 0)) {
+          ret = -2;
+          goto end;
+        }
+        key[nk++] = i;
+      }
+    }
+  }
+
+  /* Bad trace line */
+  if (ret < 0)
+    goto end;
+  ret = 0;
+
+  if (!nk)
+    goto end;
+
+  /* Same table size as ARC (1 bucket per line) */
+  bits = hash_bits(cache_size > 0 ? cache_size / CACHE_BLOCK_SIZE : nk);
+
+  printf("===== hash bench : access %ld, keys %ld, buckets 2^%u =====\n", na, nk, bits);
+  printf("%-8s %7s %7s %5s %6s", "name", "ns/key", "used%", "max", "probe");
+  for (i = 0; i < HASH_BENCH_CHAIN - 1; i++)
+    printf(" %5ld%%", i);
+  printf(" %4d+%%\n", HASH_BENCH_CHAIN - 1);
+
+  for (i = 0; i < (long)(sizeof(hash_func) / sizeof(hash_func[0])); i++) {
+    if (hash_bench_one(&hash_func[i], access, na, key, nk, bits) < 0) {
+      ret = -2;
+      break;
+    }
+  }
+
+end:
+  htab_free(&seen);
+  free(access);
+  free(key);
+  return ret;
+}/*}}}*/
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  htab.h
+ *         @brief:  Open addressing hash map. (64bit key -> 64bit value)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 11시 20분 40초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_HTAB_H
+#define __DK_HTAB_H
+
+#include <stdlib.h>
+#include <string.h>
+#include "hash.h"
+
+/* Empty slot key. (block number never be this) */
+#define HTAB_EMPTY (~0ULL)
+
+/* Max load. used / size <= 3 / 4 */
+#define HTAB_LOAD(size) ((size) - ((size) >> 2))
+
+struct htab
+{/*{{{*/
+  unsigned long long *key;
+  unsigned long long *val;
+  unsigned long size;     /* power of 2 */
+  unsigned long used;
+  int bits;
+};/*}}}*/
+
+/**
+ * Slot number of key.
+ * @param h : hash map
+ * @param key : key
+ * @return : home slot
+ */
+static inline unsigned long htab_slot(struct htab *h, unsigned long long key)
+{/*{{{*/
+  return hash_64(key, h->bits);
+}/*}}}*/
+
+/**
+ * Init hash map.
+ * @param h : hash map
+ * @param n : expected number of keys
+ * @return : error code
+ */
+static int htab_init(struct htab *h, unsigned long n)
+{/*{{{*/
+  h->bits = 4;
+  while (HTAB_LOAD(1UL << h->bits) < n)
+    h->bits++;
+
+  h->size = 1UL << h->bits;
+  h->used = 0;
+  h->key = malloc(h->size * sizeof(unsigned long long));
+  h->val = malloc(h->size * sizeof(unsigned long long));
+
+  if (!h->key || !h->val) {
+    free(h->key);
+    free(h->val);
+    return -1;
+  }
+
+  memset(h->key, 0xff, h->size * sizeof(unsigned long long));
+  return 0;
+}/*}}}*/
+
+/**
+ * Free hash map.
+ * @param h : hash map
+ */
+static void htab_free(struct htab *h)
+{/*{{{*/
+  free(h->key);
+  free(h->val);
+  h->key = h->val = NULL;
+  h->size = h->used = 0;
+}/*}}}*/
+
+/**
+ * Lookup key.
+ * @param h : hash map
+ * @param key : key
+ * @return : value pointer or NULL
+ */
+static inline unsigned long long *htab_get(struct htab *h, unsigned long long key)
+{/*{{{*/
+  unsigned long mask = h->size - 1;
+  unsigned long i = htab_slot(h, key);
+
+  while (h->key[i] != HTAB_EMPTY) {
+    if (h->key[i] == key)
+      return &h->val[i];
+    i = (i + 1) & mask;
+  }
+
+  return NULL;
+}/*}}}*/
+
+/**
+ * Double table size.
+ * @param h : hash map
+ * @return : error code
+ */
+static int htab_grow(struct htab *h)
+{/*{{{*/
+  struct htab old = *h;
+  unsigned long i = 0, j = 0;
+
+  h->bits++;
+  h->size = 1UL << h->bits;
+  h->key = malloc(h->size * sizeof(unsigned long long));
+  h->val = malloc(h->size * sizeof(unsigned long long));
+
+  if (!h->key || !h->val) {
+    free(h->key);
+    free(h->val);
+    *h = old;
+    return -1;
+  }
+
+  memset(h->key, 0xff, h->size * sizeof(unsigned long long));
+
+  for (i = 0; i < old.size; i++) {
+    if (old.key[i] == HTAB_EMPTY)
+      continue;
+
+    j = htab_slot(h, old.key[i]);
+    while (h->key[j] != HTAB_EMPTY)
+      j = (j + 1) & (h->size - 1);
+
+    h->key[j] = old.key[i];
+    h->val[j] = old.val[i];
+  }
+
+  htab_free(&old);
+  return 0;
+}/*}}}*/
+
+/**
+ * Insert or update key.
+ * @param h : hash map
+ * @param key : key
+ * @param val : value
+ * @return : value pointer or NULL (no memory)
+ */
+static inline unsigned long long *htab_put(struct htab *h, unsigned long long key,
+    unsigned long long val)
+{/*{{{*/
+  unsigned long mask = 0;
+  unsigned long i = 0;
+
+  if (h->used + 1 > HTAB_LOAD(h->size) && htab_grow(h) < 0)
+    return NULL;
+
+  mask = h->size - 1;
+  i = htab_slot(h, key);
+
+  while (h->key[i] != HTAB_EMPTY) {
+    if (h->key[i] == key) {
+      h->val[i] = val;
+      return &h->val[i];
+    }
+    i = (i + 1) & mask;
+  }
+
+  h->key[i] = key;
+  h->val[i] = val;
+  h->used++;
+  return &h->val[i];
+}/*}}}*/
+
+/**
+ * Delete key. (backward shift, no tombstone)
+ * @param h : hash map
+ * @param key : key
+ * @return : 1 (deleted), 0 (not found)
+ */
+static inline int htab_del(struct htab *h, unsigned long long key)
+{/*{{{*/
+  unsigned long mask = h->size - 1;
+  unsigned long i = htab_slot(h, key);
+  unsigned long j = 0, home = 0;
+
+  while (h->key[i] != key) {
+    if (h->key[i] == HTAB_EMPTY)
+      return 0;
+    i = (i + 1) & mask;
+  }
+
+  /* Move back following entries of the cluster */
+  j = i;
+  while (1) {
+    j = (j + 1) & mask;
+    if (h->key[j] == HTAB_EMPTY)
+      break;
+
+    home = htab_slot(h, h->key[j]);
+    /* Entry j can fill hole i only if home is not in (i, j] */
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      h->key[i] = h->key[j];
+      h->val[i] = h->val[j];
+      i = j;
+    }
+  }
+
+  h->key[i] = HTAB_EMPTY;
+  h->used--;
+  return 1;
+}/*}}}*/
+
+#endif
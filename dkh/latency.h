@@ -0,0 +1,177 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  latency.h
+ *         @brief:  Read request latency model. (trace response time on miss)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 21시 40분 19초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_LATENCY_H
+#define __DK_LATENCY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Log linear histogram. 2^LAT_SUB_BITS bucket per power of 2 (error < 1/16) */
+#define LAT_SUB_BITS 4
+#define LAT_SUB (1 << LAT_SUB_BITS)
+#define LAT_BUCKET ((64 - LAT_SUB_BITS + 1) * LAT_SUB)
+
+/*
+ * Read request is hit only if every block hits. (run_cache hit count)
+ * Hit request takes hit latency (-x lat=), miss takes respone of trace.
+ * Write latency depends on write policy, not modeled.
+ * Unit is unit of trace respone column.
+ */
+struct latency
+{/*{{{*/
+  unsigned long long hit_lat;
+  unsigned long long count[LAT_BUCKET];
+  unsigned long long n;     /* read request */
+  unsigned long long hit;   /* full hit request */
+  double sum;
+  double base;              /* sum of trace respone. (no cache) */
+};/*}}}*/
+
+/**
+ * Free latency model. (del_cm)
+ * @param lat : latency model or NULL
+ */
+void lat_free(struct latency *lat)
+{/*{{{*/
+  free(lat);
+}/*}}}*/
+
+/**
+ * Init latency model. (set_policy, -x lat=hit latency)
+ * @param cm : cache memory
+ * @param opt : option
+ * @return : error code
+ */
+int lat_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  if (opt->lat < 0)
+    return 0;
+
+  if (!(cm->lat = calloc(1, sizeof(struct latency))))
+    return -2;
+
+  cm->lat->hit_lat = opt->lat;
+  return 0;
+}/*}}}*/
+
+/**
+ * Bucket of value.
+ * @param v : latency
+ * @return : bucket
+ */
+static inline int lat_bucket(unsigned long long v)
+{/*{{{*/
+  int e = 0;
+
+  if (v < LAT_SUB)
+    return v;
+
+  e = 63 - __builtin_clzll(v);
+  return (e - LAT_SUB_BITS + 1) * LAT_SUB + ((v >> (e - LAT_SUB_BITS)) & (LAT_SUB - 1));
+}/*}}}*/
+
+/**
+ * Middle value of bucket.
+ * @param b : bucket
+ * @return : latency
+ */
+static inline double lat_value(int b)
+{/*{{{*/
+  int e = b / LAT_SUB + LAT_SUB_BITS - 1;
+  unsigned long long low = 0;
+
+  if (b < LAT_SUB)
+    return b;
+
+  low = (unsigned long long)(LAT_SUB + b % LAT_SUB) << (e - LAT_SUB_BITS);
+  return low + ((1ULL << (e - LAT_SUB_BITS)) - 1) / 2.0;
+}/*}}}*/
+
+/**
+ * Add one request.
+ * @param cm : cache memory
+ * @param wl : request
+ * @param hit : number of hit block
+ */
+static inline void lat_add(struct cache_mem *cm, struct workload *wl, int hit)
+{/*{{{*/
+  struct latency *lat = cm->lat;
+  unsigned long long v = wl->respone;
+
+  if (wl->type != READ)
+    return;
+
+  if (hit == (wl->offset + wl->size) / cm->block - wl->offset / cm->block + 1) {
+    v = lat->hit_lat;
+    lat->hit++;
+  }
+
+  lat->count[lat_bucket(v)]++;
+  lat->n++;
+  lat->sum += v;
+  lat->base += wl->respone;
+}/*}}}*/
+
+/**
+ * Latency of rank. (q of all request)
+ * @param lat : latency model
+ * @param q : 0 ~ 1
+ * @return : latency
+ */
+double lat_quantile(struct latency *lat, double q)
+{/*{{{*/
+  unsigned long long rank = (unsigned long long)(q * lat->n);
+  unsigned long long sum = 0;
+  int b = 0;
+
+  for (b = 0; b < LAT_BUCKET; b++) {
+    sum += lat->count[b];
+    if (sum > rank)
+      return lat_value(b);
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Mean latency.
+ * @param lat : latency model
+ * @return : latency
+ */
+static inline double lat_mean(struct latency *lat)
+{/*{{{*/
+  return lat->n ? lat->sum / lat->n : 0;
+}/*}}}*/
+
+/**
+ * Latency stats.
+ * @param cm : cache memory
+ */
+void lat_stats(struct cache_mem *cm)
+{/*{{{*/
+  struct latency *lat = cm->lat;
+
+  printf("===== Latency =====\n");
+  printf("read request %llu, full hit %llu (%.2f%%), hit latency %llu\n", lat->n, lat->hit,
+      lat->n ? 100.0 * lat->hit / lat->n : 0, lat->hit_lat);
+  printf("mean %.1f (no cache %.1f, %.2f%% saved)\n", lat_mean(lat),
+      lat->n ? lat->base / lat->n : 0, lat->base > 0 ? 100.0 * (1 - lat->sum / lat->base) : 0);
+  printf("p50 %.0f, p99 %.0f, p999 %.0f\n", lat_quantile(lat, 0.5), lat_quantile(lat, 0.99),
+      lat_quantile(lat, 0.999));
+}/*}}}*/
+
+#endif
@@ -0,0 +1,252 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  lirs.c
+ *         @brief:  LIRS. (Jiang & Zhang, SIGMETRICS 02)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 17시 52분 08초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+/*
+ * LIRS uses hash and slab of cache_mem, with a bigger line. (lirs_line)
+ *   S = mru : LIRS stack. (l.head, top is head) LIR, HIR, non-resident HIR.
+ *   Q = mfu : resident HIR queue. (q, front is LRU end)
+ *   N = mrug : non-resident HIR in S. (q, oldest is LRU end)
+ * Bottom of S is always LIR. (pruned)
+ * Non-resident HIR is bounded by nr_max. oldest one in N is dropped first.
+ */
+
+/* lirs_line.l.ref */
+#define LIRS_LIR 0x1
+#define LIRS_HIR 0x2
+#define LIRS_NR 0x4
+#define LIRS_IN_S 0x8
+#define LIRS_TYPE (LIRS_LIR | LIRS_HIR | LIRS_NR)
+
+struct lirs_line
+{/*{{{*/
+  struct cache_line l;      /* line, head (S), hash */
+  struct list_head q;       /* Q or N */
+};/*}}}*/
+
+struct cache_line *LIRS_cache(struct cache_mem *cm, long long line);
+
+/**
+ * lirs_line of cache line.
+ * @param l : cache line
+ * @return : lirs line
+ */
+static inline struct lirs_line *lirs_line(struct cache_line *l)
+{/*{{{*/
+  return container_of(l, struct lirs_line, l);
+}/*}}}*/
+
+/**
+ * Put line on top of S.
+ * @param cm : cache memory.
+ * @param e : line
+ */
+static inline void LIRS_top(struct cache_mem *cm, struct lirs_line *e)
+{/*{{{*/
+  if (e->l.ref & LIRS_IN_S) {
+    list_move(&e->l.head, &cm->mru.head);
+    return;
+  }
+
+  list_prepend(&e->l.head, &cm->mru.head);
+  e->l.ref |= LIRS_IN_S;
+  cm->mru.size++;
+}/*}}}*/
+
+/**
+ * Take line out of S.
+ * @param cm : cache memory.
+ * @param e : line
+ */
+static inline void LIRS_out_s(struct cache_mem *cm, struct lirs_line *e)
+{/*{{{*/
+  if (e->l.ref & LIRS_IN_S) {
+    list_remove(&e->l.head);
+    e->l.ref &= ~LIRS_IN_S;
+    cm->mru.size--;
+  }
+}/*}}}*/
+
+/**
+ * Free line. (not in S, Q, N)
+ * @param cm : cache memory.
+ * @param e : line
+ */
+static inline void LIRS_free(struct cache_mem *cm, struct lirs_line *e)
+{/*{{{*/
+  list_remove(&e->l.hash);
+  slab_free(&cm->slab, e);
+}/*}}}*/
+
+/**
+ * Prune S. remove HIR from bottom until bottom is LIR.
+ * Non-resident HIR out of S is forgotten.
+ * @param cm : cache memory.
+ */
+static void LIRS_prune(struct cache_mem *cm)
+{/*{{{*/
+  struct lirs_line *e = NULL;
+
+  while (cm->mru.size) {
+    e = lirs_line(ARC_state_lru(&cm->mru));
+    if (e->l.ref & LIRS_LIR)
+      return;
+
+    LIRS_out_s(cm, e);
+    if (e->l.ref & LIRS_NR) {
+      list_remove(&e->q);
+      cm->mrug.size--;
+      LIRS_free(cm, e);
+    }
+  }
+}/*}}}*/
+
+/**
+ * Bottom LIR of S becomes resident HIR. (end of Q)
+ * @param cm : cache memory.
+ */
+static inline void LIRS_demote(struct cache_mem *cm)
+{/*{{{*/
+  struct lirs_line *e = lirs_line(ARC_state_lru(&cm->mru));
+
+  LIRS_out_s(cm, e);
+  e->l.ref = (e->l.ref & ~LIRS_TYPE) | LIRS_HIR;
+  list_prepend(&e->q, &cm->mfu.head);
+  cm->mfu.size++;
+  cm->lir--;
+
+  LIRS_prune(cm);
+}/*}}}*/
+
+/**
+ * Evict front of Q. line in S stays as non-resident HIR.
+ * @param cm : cache memory.
+ */
+static void LIRS_evict(struct cache_mem *cm)
+{/*{{{*/
+  struct lirs_line *e = container_of(cm->mfu.head.prev, struct lirs_line, q);
+
+  list_remove(&e->q);
+  cm->mfu.size--;
+  cm->evicted++;
+
+  if (cm->evict)
+    cm->evict(cm, &e->l);
+  if (e->l.data && cm->release)
+    cm->release(e->l.data);
+  e->l.data = NULL;
+
+  if (!(e->l.ref & LIRS_IN_S)) {
+    LIRS_free(cm, e);
+    return;
+  }
+
+  e->l.ref = (e->l.ref & ~LIRS_TYPE) | LIRS_NR;
+  list_prepend(&e->q, &cm->mrug.head);
+  cm->mrug.size++;
+
+  /* Bound of non-resident HIR. forget oldest one */
+  if (cm->mrug.size > cm->nr_max) {
+    e = container_of(cm->mrug.head.prev, struct lirs_line, q);
+    list_remove(&e->q);
+    cm->mrug.size--;
+    LIRS_out_s(cm, e);
+    LIRS_free(cm, e);
+  }
+}/*}}}*/
+
+/**
+ * LIRS Main function.
+ * @param cm : cache memory.
+ * @param line : line
+ * @return : line (hit in LIR, resident HIR) or NULL (miss)
+ */
+struct cache_line *LIRS_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+  struct lirs_line *e = l ? lirs_line(l) : NULL;
+
+  /* LIR hit */
+  if (e && (e->l.ref & LIRS_LIR)) {
+    LIRS_top(cm, e);
+    LIRS_prune(cm);
+    return l;
+  }
+
+  /* Resident HIR hit */
+  if (e && (e->l.ref & LIRS_HIR)) {
+    if (e->l.ref & LIRS_IN_S) {
+      /* Small IRR. becomes LIR */
+      list_remove(&e->q);
+      cm->mfu.size--;
+      e->l.ref = (e->l.ref & ~LIRS_TYPE) | LIRS_LIR;
+      cm->lir++;
+      LIRS_top(cm, e);
+      LIRS_demote(cm);
+    } else {
+      LIRS_top(cm, e);
+      list_move(&e->q, &cm->mfu.head);
+    }
+    return l;
+  }
+
+  if (cm->c <= 0)
+    return NULL;
+
+  /* Miss. take non-resident line out of N first (evict may drop N) */
+  if (e) {
+    list_remove(&e->q);
+    cm->mrug.size--;
+  }
+
+  if (cm->lir + cm->mfu.size >= cm->c)
+    LIRS_evict(cm);
+
+  if (!e) {
+    if (!(e = slab_alloc(&cm->slab)))
+      return NULL;
+
+    e->l.line = line;
+    e->l.state = NULL;
+    e->l.data = NULL;
+    e->l.ref = 0;
+    e->l.flag = 0;
+    hash_insert(cm, &e->l);
+  }
+
+  /* Not full LIR set. (warm up) */
+  if (cm->lir < cm->lir_max) {
+    e->l.ref = (e->l.ref & ~LIRS_TYPE) | LIRS_LIR;
+    cm->lir++;
+    LIRS_top(cm, e);
+    return NULL;
+  }
+
+  if (e->l.ref & LIRS_IN_S) {
+    /* Non-resident HIR in S. becomes LIR */
+    e->l.ref = (e->l.ref & ~LIRS_TYPE) | LIRS_LIR;
+    cm->lir++;
+    LIRS_top(cm, e);
+    LIRS_demote(cm);
+  } else {
+    /* New resident HIR */
+    e->l.ref = (e->l.ref & ~LIRS_TYPE) | LIRS_HIR;
+    LIRS_top(cm, e);
+    list_prepend(&e->q, &cm->mfu.head);
+    cm->mfu.size++;
+  }
+
+  return NULL;
+}/*}}}*/
@@ -0,0 +1,53 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  lru.c
+ *         @brief:  LRU on cache_mem of ARC. (same hash, slab, replay driver)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 17시 02분 41초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+/*
+ * LRU uses only mru list. (MRU ... LRU, no ghost)
+ */
+
+struct cache_line *LRU_cache(struct cache_mem *cm, long long line);
+
+/**
+ * LRU cache
+ * Hit moves line to MRU. Miss on full cache drops LRU line.
+ * @param cm : cache memory.
+ * @param line : line
+ * @return : line (hit) or NULL (miss)
+ */
+struct cache_line *LRU_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+
+  if (l) {
+    /* Hit.. move to MRU */
+    list_move(&l->head, &cm->mru.head);
+    return l;
+  }
+
+  if (cm->c <= 0)
+    return NULL;
+
+  /* full cache. drop LRU line */
+  if (cm->mru.size >= cm->c)
+    line_move(cm, ARC_state_lru(&cm->mru), NULL);
+
+  if (!(l = create_line(cm, line)))
+    return NULL;
+
+  hash_insert(cm, l);
+  line_move(cm, l, &cm->mru);
+  return NULL;
+}/*}}}*/
@@ -0,0 +1,698 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  mrc.h
+ *         @brief:  LRU miss ratio curve. (one pass, stack distance)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 11시 42분 05초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_MRC_H
+#define __DK_MRC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "trace.h"
+#include "htab.h"
+
+/* Fenwick tree min size (access time) */
+#define MRC_INIT_CAP (1 << 20)
+
+/* Reported cache size. 2^20 (1MB) ~ 2^29 (512MB) */
+#define MRC_MIN_SHIFT 20
+#define MRC_MAX_SHIFT 29
+
+/* Max block size count (-b option) */
+#define MRC_MAX_BLOCK 8
+
+/* SHARDS. hash space, number of seed (error estimate) */
+#define SHARDS_MOD (1ULL << 24)
+#define SHARDS_SEED 4
+
+/* SHARDS default rate, sample set init size */
+#define SHARDS_RATE 0.01
+#define SHARDS_INIT_CAP (1 << 12)
+
+/*
+ * LRU stack distance of a access is number of distinct blocks accessed
+ * since last access of same block. A access hits in LRU cache of c blocks
+ * iff distance < c. So one pass histogram gives hit ratio of every size.
+ *
+ * Each live block has 1 mark in fenwick tree at its last access time.
+ * distance = marks after last access time.
+ */
+struct mrc
+{/*{{{*/
+  long block;                   /* block size (byte) */
+  struct htab last;             /* block -> last access time */
+
+  unsigned int *fen;            /* fenwick tree. (1 base) */
+  unsigned long long cap;       /* fenwick tree size */
+  unsigned long long now;       /* access time */
+  unsigned long long live;      /* distinct block */
+
+  unsigned long long *hist;     /* read distance histogram */
+  unsigned long long hist_len;
+  unsigned long long cold;      /* first read (cold miss) */
+
+  unsigned long long read;
+  unsigned long long write;
+};/*}}}*/
+
+/**
+ * Add v to time i.
+ * @param m : mrc
+ * @param i : time
+ * @param v : value (+1, -1)
+ */
+static inline void fen_add(struct mrc *m, unsigned long long i, int v)
+{/*{{{*/
+  for (; i <= m->cap; i += i & (~i + 1))
+    m->fen[i] += v;
+}/*}}}*/
+
+/**
+ * Sum of time 1 ~ i.
+ * @param m : mrc
+ * @param i : time
+ * @return : number of marks
+ */
+static inline unsigned long long fen_sum(struct mrc *m, unsigned long long i)
+{/*{{{*/
+  unsigned long long sum = 0;
+
+  for (; i > 0; i -= i & (~i + 1))
+    sum += m->fen[i];
+  return sum;
+}/*}}}*/
+
+/**
+ * Init mrc.
+ * @param m : mrc
+ * @param block : block size (byte)
+ * @param n : expected number of blocks
+ * @return : error code
+ */
+static int mrc_init(struct mrc *m, long block, unsigned long long n)
+{/*{{{*/
+  memset(m, 0, sizeof(struct mrc));
+  m->block = block;
+  m->cap = n;
+  m->hist_len = 1024;
+
+  m->fen = calloc(m->cap + 1, sizeof(unsigned int));
+  m->hist = calloc(m->hist_len, sizeof(unsigned long long));
+
+  if (!m->fen || !m->hist || htab_init(&m->last, n) < 0) {
+    free(m->fen);
+    free(m->hist);
+    return -1;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Free mrc.
+ * @param m : mrc
+ */
+static void mrc_free(struct mrc *m)
+{/*{{{*/
+  htab_free(&m->last);
+  free(m->fen);
+  free(m->hist);
+}/*}}}*/
+
+/**
+ * Renumber last access time to 1 ~ live. (fenwick tree is full)
+ * New time of a block is number of marks up to old time.
+ * @param m : mrc
+ * @return : error code
+ */
+static int mrc_compact(struct mrc *m)
+{/*{{{*/
+  unsigned long long cap = MAX(m->cap, m->live * 2);
+  unsigned long long i = 0, j = 0;
+  unsigned int *fen = NULL;
+
+  for (i = 0; i < m->last.size; i++) {
+    if (m->last.key[i] != HTAB_EMPTY)
+      m->last.val[i] = fen_sum(m, m->last.val[i]);
+  }
+
+  if (!(fen = realloc(m->fen, (cap + 1) * sizeof(unsigned int))))
+    return -1;
+
+  /* Linear build. marks at 1 ~ live */
+  m->fen = fen;
+  m->cap = cap;
+  for (i = 1; i <= cap; i++)
+    fen[i] = (i <= m->live);
+  for (i = 1; i <= cap; i++) {
+    j = i + (i & (~i + 1));
+    if (j <= cap)
+      fen[j] += fen[i];
+  }
+
+  m->now = m->live;
+  return 0;
+}/*}}}*/
+
+/**
+ * Stack distance of block. (move block to top)
+ * @param m : mrc
+ * @param blk : block number
+ * @return : stack distance, -1 (first access), -2 (no memory)
+ */
+static inline long long mrc_distance(struct mrc *m, unsigned long long blk)
+{/*{{{*/
+  unsigned long long *last = NULL;
+  long long dist = -1;
+
+  if (m->now == m->cap && mrc_compact(m) < 0)
+    return -2;
+
+  m->now++;
+  last = htab_get(&m->last, blk);
+
+  if (last) {
+    dist = m->live - fen_sum(m, *last);
+    fen_add(m, *last, -1);
+    *last = m->now;
+  } else {
+    if (!htab_put(&m->last, blk, m->now))
+      return -2;
+    m->live++;
+  }
+  fen_add(m, m->now, 1);
+
+  return dist;
+}/*}}}*/
+
+/**
+ * Access one block.
+ * @param m : mrc
+ * @param blk : block number
+ * @param type : READ or WRITE
+ * @return : stack distance, -1 (first access), -2 (no memory)
+ */
+static inline long long mrc_access(struct mrc *m, unsigned long long blk, int type)
+{/*{{{*/
+  unsigned long long *hist = NULL;
+  long long dist = mrc_distance(m, blk);
+
+  if (dist == -2)
+    return -2;
+
+  if (type == WRITE) {
+    m->write++;
+    return dist;
+  }
+
+  m->read++;
+  if (dist < 0) {
+    m->cold++;
+    return dist;
+  }
+
+  /* dist is 0 or more here. distance can jump over twice of hist */
+  while ((unsigned long long)dist >= m->hist_len) {
+    hist = realloc(m->hist, m->hist_len * 2 * sizeof(unsigned long long));
+    if (!hist)
+      return -2;
+
+    memset(hist + m->hist_len, 0, m->hist_len * sizeof(unsigned long long));
+    m->hist = hist;
+    m->hist_len *= 2;
+  }
+  m->hist[dist]++;
+
+  return dist;
+}/*}}}*/
+
+/**
+ * Access request. (split to blocks like run_cache)
+ * @param m : mrc
+ * @param wl : request
+ * @return : error code
+ */
+static inline int mrc_request(struct mrc *m, struct workload *wl)
+{/*{{{*/
+  long long start = wl->offset / m->block;
+  long long end = (wl->offset + wl->size) / m->block;
+  long long i = 0;
+
+  do {
+    if (mrc_access(m, start + i, wl->type) == -2)
+      return -1;
+    i++;
+  } while (start + i <= end);
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Read hit ratio of LRU cache.
+ * @param m : mrc
+ * @param c : cache size (block)
+ * @return : hit ratio (%)
+ */
+static double mrc_hit_ratio(struct mrc *m, unsigned long long c)
+{/*{{{*/
+  unsigned long long hit = 0;
+  unsigned long long i = 0;
+
+  if (!m->read)
+    return 0;
+
+  for (i = 0; i < c && i < m->hist_len; i++)
+    hit += m->hist[i];
+
+  return 100.0 * hit / m->read;
+}/*}}}*/
+
+/**
+ * Print curve as gnuplot data. (gnu/result_*)
+ * @param m : mrc array
+ * @param n : number of mrc
+ * @param out : output file
+ */
+static void mrc_print(struct mrc *m, int n, FILE *out)
+{/*{{{*/
+  int i = 0, s = 0;
+
+  fprintf(out, "Size");
+  for (i = 0; i < n; i++)
+    fprintf(out, "  %ldK", m[i].block / KB);
+  fprintf(out, "\n");
+
+  for (s = MRC_MIN_SHIFT; s <= MRC_MAX_SHIFT; s++) {
+    fprintf(out, "%d", s);
+    for (i = 0; i < n; i++)
+      fprintf(out, "  %.3f", mrc_hit_ratio(&m[i], (1ULL << s) / m[i].block));
+    fprintf(out, "\n");
+  }
+}/*}}}*/
+
+/**
+ * MRC main. one pass for every cache size and block size.
+ * @param t : trace
+ * @param block : block size array (byte)
+ * @param n : number of block size
+ * @param out : result.dat output
+ * @return : error code
+ */
+int run_mrc(struct trace *t, long *block, int n, FILE *out)
+{/*{{{*/
+  struct mrc *m = NULL;
+  struct workload wl;
+  int i = 0, ret = 0;
+
+  /* NULL arg */
+  if (!t || !block || !out || n <= 0) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(m = calloc(n, sizeof(struct mrc))))
+    return -2;
+
+  for (i = 0; i < n; i++) {
+    if (mrc_init(&m[i], block[i], MRC_INIT_CAP) < 0) {
+      n = i;
+      ret = -2;
+      goto end;
+    }
+  }
+
+  while ((ret = trace_next(t, &wl)) == 1) {
+    for (i = 0; i < n; i++) {
+      if (mrc_request(&m[i], &wl) < 0) {
+        ret = -2;
+        goto end;
+      }
+    }
+  }
+
+  /* Bad trace line */
+  if (ret < 0)
+    goto end;
+
+  printf("===== MRC =====\n");
+  for (i = 0; i < n; i++)
+    printf("%ldK : read %llu, write %llu, cold %llu, blocks %llu\n",
+        m[i].block / KB, m[i].read, m[i].write, m[i].cold, m[i].live);
+
+  mrc_print(m, n, out);
+
+end:
+  for (i = 0; i < n; i++)
+    mrc_free(&m[i]);
+  free(m);
+
+  return ret;
+}/*}}}*/
+
+/*
+ * SHARDS (Waldspurger et al., FAST 15)
+ * Block is sampled iff hash(block, seed) < t. (rate R = t / SHARDS_MOD)
+ * Sampled blocks keep exact stack of mrc, distance is scaled by 1 / R.
+ *   fixed rate : t is fixed.
+ *   fixed size : at most smax sampled blocks. over smax, blocks of max hash
+ *                leave the stack and t goes down to that hash. (max heap)
+ * Read is counted with weight 1 / R of its time. Histogram is cut at largest
+ * reported size, so memory is sample set only. (not footprint)
+ * Difference of all read and weighted read goes to distance 0. (SHARDS_adj)
+ */
+struct shards
+{/*{{{*/
+  struct mrc m;                 /* sampled stack (hist is not used) */
+  unsigned long long seed;
+  unsigned long long t;         /* threshold */
+  unsigned long long smax;      /* fixed size. 0 is fixed rate */
+
+  unsigned long long *heap;     /* fixed size. sampled block, max hash on top */
+  unsigned long long n;
+
+  double *hist;                 /* weighted read of scaled distance */
+  unsigned long long hist_len;  /* last is over largest size */
+  double wread;                 /* weighted read */
+  unsigned long long total;     /* all read */
+  unsigned long long sampled;   /* sampled access */
+};/*}}}*/
+
+/**
+ * Hash of block. (0 ~ SHARDS_MOD - 1)
+ * @param s : shards
+ * @param blk : block number
+ * @return : hash
+ */
+static inline unsigned long long shards_hash(struct shards *s, unsigned long long blk)
+{/*{{{*/
+  return mix_64(blk ^ s->seed) & (SHARDS_MOD - 1);
+}/*}}}*/
+
+/**
+ * Init shards.
+ * @param s : shards
+ * @param block : block size (byte)
+ * @param rate : fixed rate (0 < rate <= 1) or sample set size (> 1)
+ * @param seed : seed number
+ * @return : error code
+ */
+static int shards_init(struct shards *s, long block, double rate, int seed)
+{/*{{{*/
+  memset(s, 0, sizeof(struct shards));
+  s->seed = mix_64(seed + 1);
+
+  if (rate > 1) {
+    s->smax = rate;
+    s->t = SHARDS_MOD;
+    s->heap = malloc((s->smax + 1) * sizeof(unsigned long long));
+  } else {
+    s->t = MAX((unsigned long long)(rate * SHARDS_MOD), 1);
+  }
+
+  s->hist_len = (1ULL << MRC_MAX_SHIFT) / block + 1;
+  s->hist = calloc(s->hist_len, sizeof(double));
+
+  if ((s->smax && !s->heap) || !s->hist ||
+      mrc_init(&s->m, block, s->smax ? s->smax + 1 : SHARDS_INIT_CAP) < 0) {
+    free(s->heap);
+    free(s->hist);
+    return -1;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Free shards.
+ * @param s : shards
+ */
+static void shards_free(struct shards *s)
+{/*{{{*/
+  mrc_free(&s->m);
+  free(s->heap);
+  free(s->hist);
+}/*}}}*/
+
+/**
+ * Push sampled block to heap.
+ * @param s : shards
+ * @param blk : block number
+ */
+static void shards_push(struct shards *s, unsigned long long blk)
+{/*{{{*/
+  unsigned long long h = shards_hash(s, blk);
+  unsigned long long i = s->n++, p = 0;
+
+  while (i > 0) {
+    p = (i - 1) >> 1;
+    if (shards_hash(s, s->heap[p]) >= h)
+      break;
+    s->heap[i] = s->heap[p];
+    i = p;
+  }
+  s->heap[i] = blk;
+}/*}}}*/
+
+/**
+ * Pop block of max hash from heap.
+ * @param s : shards
+ * @return : block number
+ */
+static unsigned long long shards_pop(struct shards *s)
+{/*{{{*/
+  unsigned long long top = s->heap[0];
+  unsigned long long blk = s->heap[--s->n];
+  unsigned long long h = shards_hash(s, blk);
+  unsigned long long i = 0, c = 0;
+
+  while ((c = 2 * i + 1) < s->n) {
+    if (c + 1 < s->n && shards_hash(s, s->heap[c + 1]) > shards_hash(s, s->heap[c]))
+      c++;
+    if (shards_hash(s, s->heap[c]) <= h)
+      break;
+    s->heap[i] = s->heap[c];
+    i = c;
+  }
+  if (s->n)
+    s->heap[i] = blk;
+
+  return top;
+}/*}}}*/
+
+/**
+ * Over sample set size. lower t and drop blocks of max hash from stack.
+ * @param s : shards
+ */
+static void shards_shrink(struct shards *s)
+{/*{{{*/
+  unsigned long long blk = 0;
+  unsigned long long *last = NULL;
+
+  s->t = shards_hash(s, s->heap[0]);
+  while (s->n && shards_hash(s, s->heap[0]) >= s->t) {
+    blk = shards_pop(s);
+    if ((last = htab_get(&s->m.last, blk))) {
+      fen_add(&s->m, *last, -1);
+      htab_del(&s->m.last, blk);
+      s->m.live--;
+    }
+  }
+}/*}}}*/
+
+/**
+ * Access one block.
+ * @param s : shards
+ * @param blk : block number
+ * @param type : READ or WRITE
+ * @return : error code
+ */
+static inline int shards_access(struct shards *s, unsigned long long blk, int type)
+{/*{{{*/
+  unsigned long long live = s->m.live;
+  double w = 0, sd = 0;
+  long long dist = 0;
+
+  if (type == READ)
+    s->total++;
+
+  if (shards_hash(s, blk) >= s->t)
+    return 0;
+
+  s->sampled++;
+  if ((dist = mrc_distance(&s->m, blk)) == -2)
+    return -2;
+
+  /* New sampled block */
+  if (s->smax && s->m.live > live) {
+    shards_push(s, blk);
+    if (s->m.live > s->smax)
+      shards_shrink(s);
+  }
+
+  if (type != READ)
+    return 0;
+
+  w = (double)SHARDS_MOD / s->t;
+  s->wread += w;
+  if (dist < 0)
+    return 0;
+
+  sd = dist * w;
+  s->hist[sd < s->hist_len - 1 ? (unsigned long long)sd : s->hist_len - 1] += w;
+  return 0;
+}/*}}}*/
+
+/**
+ * Access request. (split to blocks like run_cache)
+ * @param s : shards
+ * @param wl : request
+ * @return : error code
+ */
+static inline int shards_request(struct shards *s, struct workload *wl)
+{/*{{{*/
+  long long start = wl->offset / s->m.block;
+  long long end = (wl->offset + wl->size) / s->m.block;
+  long long i = 0;
+
+  for (i = start; i <= end; i++) {
+    if (shards_access(s, i, wl->type) < 0)
+      return -1;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Approximate hit ratio of LRU cache.
+ * @param s : shards
+ * @param c : cache size (block)
+ * @return : hit ratio (%)
+ */
+static double shards_hit_ratio(struct shards *s, unsigned long long c)
+{/*{{{*/
+  double hit = 0;
+  unsigned long long i = 0;
+
+  if (!s->total)
+    return 0;
+
+  hit = s->total - s->wread;
+  for (i = 0; i < c && i < s->hist_len - 1; i++)
+    hit += s->hist[i];
+
+  return MAX(0, MIN(100, 100.0 * hit / s->total));
+}/*}}}*/
+
+/**
+ * Print curve as gnuplot data. mean and stddev of seeds. (gnu/result_shards)
+ * @param s : shards array. (block x seed)
+ * @param n : number of block size
+ * @param out : output file
+ */
+static void shards_print(struct shards *s, int n, FILE *out)
+{/*{{{*/
+  struct shards *e = NULL;
+  double r = 0, sum = 0, sq = 0, mean = 0;
+  int i = 0, j = 0, k = 0;
+
+  fprintf(out, "Size");
+  for (i = 0; i < n; i++)
+    fprintf(out, "  %ldK  sd", s[i * SHARDS_SEED].m.block / KB);
+  fprintf(out, "\n");
+
+  for (k = MRC_MIN_SHIFT; k <= MRC_MAX_SHIFT; k++) {
+    fprintf(out, "%d", k);
+    for (i = 0; i < n; i++) {
+      sum = sq = 0;
+      for (j = 0; j < SHARDS_SEED; j++) {
+        e = &s[i * SHARDS_SEED + j];
+        r = shards_hit_ratio(e, (1ULL << k) / e->m.block);
+        sum += r;
+        sq += r * r;
+      }
+
+      mean = sum / SHARDS_SEED;
+      fprintf(out, "  %.3f  %.3f", mean, sqrt(MAX(0, sq / SHARDS_SEED - mean * mean)));
+    }
+    fprintf(out, "\n");
+  }
+}/*}}}*/
+
+/**
+ * SHARDS main. one pass, SHARDS_SEED samples for every block size.
+ * @param t : trace
+ * @param block : block size array (byte)
+ * @param n : number of block size
+ * @param rate : fixed rate (0 < rate <= 1) or sample set size (> 1)
+ * @param out : result.dat output
+ * @return : error code
+ */
+int run_shards(struct trace *t, long *block, int n, double rate, FILE *out)
+{/*{{{*/
+  struct shards *s = NULL;
+  struct workload wl;
+  struct timespec st, et;
+  int i = 0, ns = 0, ret = 0;
+
+  /* NULL arg */
+  if (!t || !block || !out || n <= 0 || rate <= 0) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(s = calloc(n * SHARDS_SEED, sizeof(struct shards))))
+    return -2;
+
+  for (ns = 0; ns < n * SHARDS_SEED; ns++) {
+    if (shards_init(&s[ns], block[ns / SHARDS_SEED], rate, ns % SHARDS_SEED) < 0) {
+      ret = -2;
+      goto end;
+    }
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &st);
+  while ((ret = trace_next(t, &wl)) == 1) {
+    for (i = 0; i < ns; i++) {
+      if (shards_request(&s[i], &wl) < 0) {
+        ret = -2;
+        goto end;
+      }
+    }
+  }
+
+  /* Bad trace line */
+  if (ret < 0)
+    goto end;
+  clock_gettime(CLOCK_MONOTONIC, &et);
+
+  printf("===== SHARDS =====\n");
+  for (i = 0; i < ns; i++)
+    printf("%ldK seed %d : read %llu, sampled %llu, blocks %llu, rate %.5f\n",
+        s[i].m.block / KB, i % SHARDS_SEED, s[i].total, s[i].sampled, s[i].m.live,
+        (double)s[i].t / SHARDS_MOD);
+  printf("time : %.3f sec\n", (et.tv_sec - st.tv_sec) + (et.tv_nsec - st.tv_nsec) / 1e9);
+
+  shards_print(s, n, out);
+
+end:
+  for (i = 0; i < ns; i++)
+    shards_free(&s[i]);
+  free(s);
+
+  return ret;
+}/*}}}*/
+
+#endif
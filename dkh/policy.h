@@ -0,0 +1,524 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  policy.h
+ *         @brief:  Replacement policy table. one replay driver for every policy.
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 17시 10분 05초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_POLICY_H
+#define __DK_POLICY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Policy and parameter. (-p name, -x key=value,..) */
+struct cache_opt
+{/*{{{*/
+  int policy;               /* POLICY_* */
+  double p;                 /* initial p of ARC, CAR. ratio of c. (<0 default) */
+  double kin;               /* 2Q Kin, Kout. ratio of c */
+  double kout;
+  double hir;               /* LIRS resident HIR. ratio of c */
+  double nr;                /* LIRS max non-resident HIR. ratio of c */
+  double small;             /* S3-FIFO S. ratio of c */
+  int move;                 /* S3-FIFO S -> M counter */
+  int tlfu;                 /* ARC TinyLFU admission */
+  long ra;                  /* readahead window (block). 0 is off */
+  int stream;               /* readahead stream table size */
+  int wmode;                /* WB_* write policy */
+  double dirty;             /* write back flusher threshold. ratio of c (0 off) */
+  long lat;                 /* read hit latency. (<0 no latency model) */
+  int tenant;               /* TENANT_* key and partition mode */
+};/*}}}*/
+
+int prefetch_init(struct cache_mem *cm, struct cache_opt *opt);
+int wb_init(struct cache_mem *cm, struct cache_opt *opt);
+int wb_mode(char *name);
+int lat_init(struct cache_mem *cm, struct cache_opt *opt);
+int tenant_init(struct cache_mem *cm, struct cache_opt *opt);
+int tenant_mode(char *name);
+
+/*
+ * Every policy works on cache_mem of arc.c. (hash, slab, lists)
+ * access : lookup + insert. return resident line on hit, NULL on miss.
+ *          (NULL for engine without cache_line, fifo.c. hit is 1)
+ * run : replay one request. made by POLICY_RUN, access is inlined.
+ * resize : change c of running cache, evict down to new c. (or NULL)
+ */
+struct cache_policy
+{/*{{{*/
+  char *name;
+  int (*init)(struct cache_mem *cm, struct cache_opt *opt);
+  struct cache_line *(*lookup)(struct cache_mem *cm, long long line);
+  struct cache_line *(*access)(struct cache_mem *cm, long long line);
+  void (*stats)(struct cache_mem *cm);
+  int (*run)(struct cache_mem *cm, struct workload *wl);
+  int (*resize)(struct cache_mem *cm, long c);
+};/*}}}*/
+
+/*
+ * Replay loop of one policy. fn is called directly for every block,
+ * no indirect call in block loop. return number of hit block.
+ */
+#define POLICY_RUN(name, fn) \
+  static int run_##name(struct cache_mem *cm, struct workload *wl) \
+  { \
+    long long key = cm->key; \
+    long long i = wl->offset / cm->block; \
+    long long end = (wl->offset + wl->size) / cm->block; \
+    int hit = 0, n = 0; \
+    for (; i <= end; i++) { \
+      hit = !!fn(cm, key | i); \
+      n += hit; \
+      if (wl->type == READ) { \
+        cm->read++; \
+        cm->hit += hit; \
+      } else if (wl->type == WRITE) { \
+        cm->write++; \
+      } \
+    } \
+    return n; \
+  }
+
+POLICY_RUN(arc, ARC_cache)
+POLICY_RUN(car, CAR_cache)
+POLICY_RUN(lru, LRU_cache)
+POLICY_RUN(2q, TWOQ_cache)
+POLICY_RUN(lirs, LIRS_cache)
+POLICY_RUN(clockpro, CLOCKPRO_cache)
+POLICY_RUN(s3fifo, S3FIFO_cache)
+POLICY_RUN(sieve, SIEVE_cache)
+
+/**
+ * Resident line. (no state change)
+ * @param cm : cache memory
+ * @param line : line
+ * @return : line in mru, mfu or NULL
+ */
+static struct cache_line *cache_lookup(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+
+  if (l && (l->state == &cm->mru || l->state == &cm->mfu))
+    return l;
+  return NULL;
+}/*}}}*/
+
+/**
+ * ARC init. p is c / 2 or -x p=ratio. -x tlfu=1 is admission filter.
+ * @param cm : cache memory
+ * @param opt : parameter
+ * @return : error code
+ */
+static int ARC_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  cm->p = opt->p >= 0 ? (long)(opt->p * cm->c) : cm->c >> 1;
+  cm->p = MIN(cm->p, cm->c);
+
+  if (opt->tlfu && !(cm->admit = tlfu_init(cm->c)))
+    return -2;
+  return 0;
+}/*}}}*/
+
+/**
+ * ARC resize. p is kept in 0 ~ c, T1 + B1 <= c, directory <= 2c.
+ * @param cm : cache memory
+ * @param c : new cache size (line)
+ * @return : error code
+ */
+static int ARC_resize(struct cache_mem *cm, long c)
+{/*{{{*/
+  if (c < 0)
+    return -1;
+
+  cm->c = c;
+  cm->p = MIN(cm->p, c);
+  while (cm->mru.size + cm->mfu.size > c)
+    ARC_replace(cm, 0);
+  while (cm->mru.size + cm->mrug.size > c && cm->mrug.size)
+    line_move(cm, ARC_state_lru(&cm->mrug), NULL);
+  while (cm->mru.size + cm->mfu.size + cm->mrug.size + cm->mfug.size > 2 * c && cm->mfug.size)
+    line_move(cm, ARC_state_lru(&cm->mfug), NULL);
+  return 0;
+}/*}}}*/
+
+/**
+ * CAR init. T1 target starts with 0 or -x p=ratio.
+ * @param cm : cache memory
+ * @param opt : parameter
+ * @return : error code
+ */
+static int CAR_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  cm->p = opt->p >= 0 ? (long)(opt->p * cm->c) : 0;
+  cm->p = MIN(cm->p, cm->c);
+  return 0;
+}/*}}}*/
+
+/**
+ * LRU resize. drop LRU line down to c.
+ * @param cm : cache memory
+ * @param c : new cache size (line)
+ * @return : error code
+ */
+static int LRU_resize(struct cache_mem *cm, long c)
+{/*{{{*/
+  if (c < 0)
+    return -1;
+
+  cm->c = c;
+  while (cm->mru.size > c)
+    line_move(cm, ARC_state_lru(&cm->mru), NULL);
+  return 0;
+}/*}}}*/
+
+/**
+ * LRU stats.
+ * @param cm : cache memory
+ */
+static void LRU_stats(struct cache_mem *cm)
+{/*{{{*/
+  printf("===== Info =====\n");
+  printf("lru %ld \n", cm->mru.size);
+}/*}}}*/
+
+/**
+ * 2Q init. Kin, Kout is ratio of c. (default 1/4, 1/2)
+ * A1out is bounded by c. (line slab is 2c)
+ * @param cm : cache memory
+ * @param opt : parameter
+ * @return : error code
+ */
+static int TWOQ_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  if (opt->kin < 0 || opt->kin > 1 || opt->kout < 0 || opt->kout > 1) {
+    printf("[FAIL] kin, kout is 0 ~ 1, %s \n", __func__);
+    return -1;
+  }
+
+  cm->kin = (long)(opt->kin * cm->c);
+  cm->kout = (long)(opt->kout * cm->c);
+  return 0;
+}/*}}}*/
+
+/**
+ * 2Q stats.
+ * @param cm : cache memory
+ */
+static void TWOQ_stats(struct cache_mem *cm)
+{/*{{{*/
+  printf("===== Info =====\n");
+  printf("a1in %ld (kin %ld)\n", cm->mru.size, cm->kin);
+  printf("a1out %ld (kout %ld)\n", cm->mrug.size, cm->kout);
+  printf("am %ld \n", cm->mfu.size);
+  printf("a1out hit %ld \n", cm->b1_hit);
+}/*}}}*/
+
+/**
+ * LIRS init. line slab and hash are made again for lirs_line.
+ * Resident HIR is hir * c (at least 1), non-resident HIR is nr * c.
+ * @param cm : cache memory
+ * @param opt : parameter
+ * @return : error code
+ */
+static int LIRS_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  long hir = MAX((long)(opt->hir * cm->c), 1);
+
+  if (opt->hir < 0 || opt->hir >= 1 || opt->nr < 0) {
+    printf("[FAIL] hir is 0 ~ 1, nr >= 0, %s \n", __func__);
+    return -1;
+  }
+
+  cm->lir_max = cm->c > 1 ? cm->c - MIN(hir, cm->c - 1) : 0;
+  cm->nr_max = (long)(opt->nr * cm->c);
+
+  /* resident c + non-resident nr_max (+1 new line before evict) */
+  slab_destroy(&cm->slab);
+  free(cm->hash.bucket);
+  cm->hash.bucket = NULL;
+  if (slab_init(&cm->slab, sizeof(struct lirs_line), cm->c + cm->nr_max + 1) < 0 ||
+      init_hash_list(cm, cm->c + cm->nr_max) < 0)
+    return -2;
+
+  return 0;
+}/*}}}*/
+
+/**
+ * LIRS resident line. (no state change)
+ * @param cm : cache memory
+ * @param line : line
+ * @return : LIR, resident HIR line or NULL
+ */
+static struct cache_line *LIRS_lookup(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+
+  if (l && (l->ref & (LIRS_LIR | LIRS_HIR)))
+    return l;
+  return NULL;
+}/*}}}*/
+
+/**
+ * LIRS stats.
+ * @param cm : cache memory
+ */
+static void LIRS_stats(struct cache_mem *cm)
+{/*{{{*/
+  printf("===== Info =====\n");
+  printf("lir %ld (max %ld)\n", cm->lir, cm->lir_max);
+  printf("hir %ld \n", cm->mfu.size);
+  printf("non-resident %ld (max %ld)\n", cm->mrug.size, cm->nr_max);
+  printf("stack %ld \n", cm->mru.size);
+}/*}}}*/
+
+/**
+ * CLOCK-Pro init. cold target starts small (CLOCKPRO_MIN) like paper. (-x p=ratio)
+ * @param cm : cache memory
+ * @param opt : parameter
+ * @return : error code
+ */
+static int CLOCKPRO_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  cm->p = opt->p >= 0 ? (long)(opt->p * cm->c) : CLOCKPRO_MIN(cm->c);
+  cm->p = MAX(MIN(cm->p, cm->c - CLOCKPRO_MIN(cm->c)), CLOCKPRO_MIN(cm->c));
+  return 0;
+}/*}}}*/
+
+/**
+ * CLOCK-Pro stats.
+ * @param cm : cache memory
+ */
+static void CLOCKPRO_stats(struct cache_mem *cm)
+{/*{{{*/
+  printf("===== Info =====\n");
+  printf("hot %ld \n", cm->mru.size);
+  printf("cold %ld (target %ld)\n", cm->mfu.size, cm->p);
+  printf("test %ld \n", cm->mrug.size);
+  printf("test hit %ld \n", cm->b1_hit);
+}/*}}}*/
+
+/**
+ * S3-FIFO, SIEVE init. line slab and hash of cache_mem are not used.
+ * @param cm : cache memory
+ * @param opt : parameter
+ * @return : error code
+ */
+static int FIFO_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  struct fifo *f = NULL;
+  int ret = 0;
+
+  if (opt->small <= 0 || opt->small >= 1 || opt->move < 1 || opt->move > FIFO_FREQ_MAX) {
+    printf("[FAIL] small is 0 ~ 1, move is 1 ~ %d, %s \n", FIFO_FREQ_MAX, __func__);
+    return -1;
+  }
+
+  if (!(f = calloc(1, sizeof(struct fifo))))
+    return -2;
+
+  cm->priv = f;
+  cm->priv_free = fifo_free;
+  slab_destroy(&cm->slab);
+  free(cm->hash.bucket);
+  cm->hash.bucket = NULL;
+  cm->hash.size = 0;
+
+  if (cm->policy == POLICY_SIEVE) {
+    /* log of 2c slot. holes are squeezed when full */
+    ret = fifo_ring_init(&f->s, 2 * cm->c);
+  } else {
+    f->small_max = MAX((long)(opt->small * cm->c), 1);
+    f->main_max = MAX(cm->c - (long)f->small_max, 0);
+    f->ghost_max = f->main_max;
+    f->move = opt->move;
+    ret = fifo_ring_init(&f->s, cm->c + 1) | fifo_ring_init(&f->m, cm->c + 1) |
+      fifo_ring_init(&f->g, f->ghost_max);
+  }
+
+  if (ret < 0 || htab_init(&f->map, cm->c + f->ghost_max + 1) < 0)
+    return -2;
+
+  cm->priv_meta = sizeof(struct fifo) + f->map.size * 2 * sizeof(unsigned long long) +
+    ((f->s.slot ? f->s.mask + 1 : 0) + (f->m.slot ? f->m.mask + 1 : 0) +
+     (f->g.slot ? f->g.mask + 1 : 0)) * sizeof(unsigned long long);
+  return 0;
+}/*}}}*/
+
+/**
+ * S3-FIFO, SIEVE stats.
+ * @param cm : cache memory
+ */
+static void FIFO_stats(struct cache_mem *cm)
+{/*{{{*/
+  struct fifo *f = cm->priv;
+
+  printf("===== Info =====\n");
+  if (cm->policy == POLICY_SIEVE) {
+    printf("live %ld, log %llu (slot %llu)\n", f->live, f->s.head - f->s.tail, f->s.mask + 1);
+    printf("squeeze %ld \n", f->squeeze);
+    return;
+  }
+
+  printf("small %llu (max %llu)\n", f->s.head - f->s.tail, f->small_max);
+  printf("main %llu (max %llu)\n", f->m.head - f->m.tail, f->main_max);
+  printf("ghost %llu (max %llu), ghost hit %ld \n", f->g.head - f->g.tail, f->ghost_max,
+      f->ghost_hit);
+}/*}}}*/
+
+/* Index is POLICY_* */
+static struct cache_policy cache_policy[] = {
+  {"arc", ARC_init, cache_lookup, ARC_cache, ARC_stats, run_arc, ARC_resize},
+  {"car", CAR_init, cache_lookup, CAR_cache, ARC_stats, run_car, NULL},
+  {"lru", NULL, cache_lookup, LRU_cache, LRU_stats, run_lru, LRU_resize},
+  {"2q", TWOQ_init, cache_lookup, TWOQ_cache, TWOQ_stats, run_2q, NULL},
+  {"lirs", LIRS_init, LIRS_lookup, LIRS_cache, LIRS_stats, run_lirs, NULL},
+  {"clockpro", CLOCKPRO_init, cache_lookup, CLOCKPRO_cache, CLOCKPRO_stats, run_clockpro, NULL},
+  {"s3fifo", FIFO_init, NULL, NULL, FIFO_stats, run_s3fifo, NULL},
+  {"sieve", FIFO_init, NULL, NULL, FIFO_stats, run_sieve, NULL},
+};
+
+#define POLICY_NUM (int)(sizeof(cache_policy) / sizeof(cache_policy[0]))
+
+/**
+ * Default option. (arc)
+ * @param opt : option
+ */
+void init_cache_opt(struct cache_opt *opt)
+{/*{{{*/
+  opt->policy = POLICY_ARC;
+  opt->p = -1;
+  opt->kin = 0.25;
+  opt->kout = 0.5;
+  opt->hir = 0.01;
+  opt->nr = 2;
+  opt->small = 0.1;
+  opt->move = 1;
+  opt->tlfu = 0;
+  opt->ra = 0;
+  opt->stream = 32;
+  opt->wmode = 0;
+  opt->dirty = 0;
+  opt->lat = -1;
+  opt->tenant = 0;
+}/*}}}*/
+
+/**
+ * Policy name to number.
+ * @param name : policy name. (arc, car, lru, 2q, lirs, clockpro, s3fifo, sieve)
+ * @return : policy number or -1
+ */
+int policy_id(char *name)
+{/*{{{*/
+  int i = 0;
+
+  for (i = 0; i < POLICY_NUM; i++) {
+    if (strcmp(cache_policy[i].name, name) == 0)
+      return i;
+  }
+
+  return -1;
+}/*}}}*/
+
+/**
+ * Parse policy parameter. ("p=0.3,kin=0.25,hir=0.01,..")
+ * @param opt : option
+ * @param str : option string
+ * @return : error code
+ */
+int parse_cache_opt(struct cache_opt *opt, char *str)
+{/*{{{*/
+  char *tmp = NULL;
+  char *save = NULL;
+  char *val = NULL;
+
+  for (tmp = strtok_r(str, ",", &save); tmp; tmp = strtok_r(NULL, ",", &save)) {
+    if (!(val = strchr(tmp, '='))) {
+      printf("[FAIL] no value %s, %s \n", tmp, __func__);
+      return -1;
+    }
+    *val++ = '\0';
+
+    if (strcmp(tmp, "p") == 0) {
+      opt->p = atof(val);
+    } else if (strcmp(tmp, "kin") == 0) {
+      opt->kin = atof(val);
+    } else if (strcmp(tmp, "kout") == 0) {
+      opt->kout = atof(val);
+    } else if (strcmp(tmp, "hir") == 0) {
+      opt->hir = atof(val);
+    } else if (strcmp(tmp, "nr") == 0) {
+      opt->nr = atof(val);
+    } else if (strcmp(tmp, "small") == 0) {
+      opt->small = atof(val);
+    } else if (strcmp(tmp, "move") == 0) {
+      opt->move = atoi(val);
+    } else if (strcmp(tmp, "tlfu") == 0) {
+      opt->tlfu = atoi(val);
+    } else if (strcmp(tmp, "ra") == 0) {
+      opt->ra = atol(val);
+    } else if (strcmp(tmp, "stream") == 0) {
+      opt->stream = atoi(val);
+    } else if (strcmp(tmp, "write") == 0) {
+      if ((opt->wmode = wb_mode(val)) < 0) {
+        printf("[FAIL] write is wt or wb, %s \n", __func__);
+        return -1;
+      }
+    } else if (strcmp(tmp, "dirty") == 0) {
+      opt->dirty = atof(val);
+    } else if (strcmp(tmp, "lat") == 0) {
+      opt->lat = atol(val);
+    } else if (strcmp(tmp, "tenant") == 0) {
+      if ((opt->tenant = tenant_mode(val)) < 0) {
+        printf("[FAIL] tenant is shared, static or dyn, %s \n", __func__);
+        return -1;
+      }
+    } else {
+      printf("[FAIL] unknown parameter %s, %s \n", tmp, __func__);
+      return -1;
+    }
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Set replacement policy and parameter. (before first access)
+ * @param cm : cache memory.
+ * @param opt : option
+ * @return : error code
+ */
+int set_policy(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  int ret = 0;
+
+  if (!cm || !opt || opt->policy < 0 || opt->policy >= POLICY_NUM)
+    return -1;
+
+  /* Admission filter is in ARC_cache only */
+  if (opt->tlfu && opt->policy != POLICY_ARC) {
+    printf("[FAIL] tlfu runs with arc only, %s \n", __func__);
+    return -1;
+  }
+
+  cm->policy = opt->policy;
+  if (cache_policy[cm->policy].init && (ret = cache_policy[cm->policy].init(cm, opt)) < 0)
+    return ret;
+  if ((ret = prefetch_init(cm, opt)) < 0 || (ret = wb_init(cm, opt)) < 0)
+    return ret;
+  if ((ret = lat_init(cm, opt)) < 0)
+    return ret;
+  return tenant_init(cm, opt);
+}/*}}}*/
+
+#endif
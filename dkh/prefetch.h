@@ -0,0 +1,266 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  prefetch.h
+ *         @brief:  Sequential / strided stream detection and readahead. (run_cache)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 20시 31분 47초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_PREFETCH_H
+#define __DK_PREFETCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Matched request count to start readahead */
+#define PF_TRIGGER 2
+
+/*
+ * Stream table is per disk (host << 16 | disk), LRU replaced.
+ * Request continues a stream if it starts in (last start, last end + 1]
+ * (sequential. end block of request is inclusive, run_cache) or at
+ * last start + stride (strided). New stream guesses stride from the
+ * latest stream of same disk.
+ * Readahead issues next requests of stream at stride, ra block ahead.
+ * Prefetched line has LINE_PREFETCH until first demand access (hit) or
+ * eviction (waste). Policy needs cache_line. (lookup, access)
+ * Prefetch goes in by policy access as first touch. (ARC T1, CAR ref 0)
+ * First demand access of prefetched line is that first touch, not a
+ * second reference. it hits without policy access, so it is not promoted
+ * to frequency side (T2, ref bit) until next access.
+ */
+struct pf_stream
+{/*{{{*/
+  long long key;            /* host << 16 | disk. -1 is empty */
+  long long start, end;     /* last request (block) */
+  long long stride;         /* start delta. 0 is new */
+  long long ahead;          /* last prefetched request start. -1 is none */
+  int run;                  /* matched request */
+  unsigned long long time;  /* last use */
+};/*}}}*/
+
+struct prefetch
+{/*{{{*/
+  struct pf_stream *s;
+  int n;
+  long ra;                  /* readahead window (block) */
+  unsigned long long now;
+
+  void (*evict)(struct cache_mem *cm, struct cache_line *l);  /* chained hook */
+
+  long issue;               /* backend read by readahead */
+  long hit;                 /* demand read on prefetched line */
+  long waste;               /* evicted or overwritten before read */
+  long pending;             /* prefetched, not used yet */
+  long seq, strided;        /* detected stream */
+};/*}}}*/
+
+/**
+ * Free prefetch. (del_cm)
+ * @param pf : prefetch or NULL
+ */
+void prefetch_free(struct prefetch *pf)
+{/*{{{*/
+  if (!pf)
+    return;
+
+  free(pf->s);
+  free(pf);
+}/*}}}*/
+
+/**
+ * Evict hook. prefetched line leaves unused.
+ * @param cm : cache memory
+ * @param l : line
+ */
+static void prefetch_evict(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  if (l->flag & LINE_PREFETCH) {
+    l->flag &= ~LINE_PREFETCH;
+    cm->pf->waste++;
+    cm->pf->pending--;
+  }
+
+  if (cm->pf->evict)
+    cm->pf->evict(cm, l);
+}/*}}}*/
+
+/**
+ * Init prefetch. (set_policy, -x ra=block,stream=n)
+ * @param cm : cache memory
+ * @param opt : option
+ * @return : error code
+ */
+int prefetch_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  struct prefetch *pf = NULL;
+  int i = 0;
+
+  if (opt->ra <= 0)
+    return 0;
+
+  if (!cache_policy[cm->policy].lookup || opt->stream <= 0) {
+    printf("[FAIL] prefetch needs cache_line policy, stream > 0, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(pf = calloc(1, sizeof(struct prefetch))))
+    return -2;
+  if (!(pf->s = malloc(opt->stream * sizeof(struct pf_stream)))) {
+    free(pf);
+    return -2;
+  }
+
+  pf->n = opt->stream;
+  pf->ra = opt->ra;
+  for (i = 0; i < pf->n; i++) {
+    pf->s[i].key = -1;
+    pf->s[i].time = 0;
+  }
+
+  pf->evict = cm->evict;
+  cm->evict = prefetch_evict;
+  cm->pf = pf;
+  return 0;
+}/*}}}*/
+
+/**
+ * Read block ahead. (not counted as demand access)
+ * @param cm : cache memory
+ * @param line : line
+ */
+static inline void prefetch_block(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = NULL;
+
+  if (line < 0 || cache_policy[cm->policy].lookup(cm, line))
+    return;
+
+  cm->pf->issue++;
+  cache_policy[cm->policy].access(cm, line);
+
+  /* admission filter may reject */
+  if ((l = cache_policy[cm->policy].lookup(cm, line))) {
+    l->flag |= LINE_PREFETCH;
+    cm->pf->pending++;
+  }
+}/*}}}*/
+
+/**
+ * Find or make stream of request, and read ahead.
+ * @param cm : cache memory
+ * @param key : host << 16 | disk
+ * @param start : first block of request
+ * @param end : last block of request
+ */
+static void prefetch_stream(struct cache_mem *cm, long long key, long long start, long long end)
+{/*{{{*/
+  struct prefetch *pf = cm->pf;
+  struct pf_stream *e = NULL, *old = &pf->s[0], *last = NULL;
+  long long s = 0, b = 0, depth = 0, k = 0;
+  int i = 0, seq = 0;
+
+  pf->now++;
+  for (i = 0; i < pf->n; i++) {
+    e = &pf->s[i];
+    if (e->key == key && ((start > e->start && start <= e->end + 1) ||
+          (e->stride && start == e->start + e->stride)))
+      break;
+    if (e->key == key && (!last || e->time > last->time))
+      last = e;
+    if (e->time < old->time)
+      old = e;
+  }
+
+  /* New stream */
+  if (i == pf->n) {
+    old->key = key;
+    old->start = start;
+    old->end = end;
+    old->stride = last ? start - last->start : 0;
+    old->ahead = -1;
+    old->run = 0;
+    old->time = pf->now;
+    return;
+  }
+
+  seq = start > e->start && start <= e->end + 1;
+  if (start - e->start != e->stride)
+    e->ahead = -1;
+  e->stride = start - e->start;
+  e->start = start;
+  e->end = end;
+  e->time = pf->now;
+
+  if (++e->run < PF_TRIGGER)
+    return;
+  if (e->run == PF_TRIGGER) {
+    if (seq)
+      pf->seq++;
+    else
+      pf->strided++;
+  }
+
+  /* Next requests at stride, ra block ahead */
+  depth = MAX(1, pf->ra / (end - start + 1));
+  for (k = 1; k <= depth; k++) {
+    s = start + k * e->stride;
+    if (e->ahead >= 0 && (e->stride > 0 ? s <= e->ahead : s >= e->ahead))
+      continue;
+
+    for (b = s; b <= s + end - start; b++)
+      prefetch_block(cm, cm->key | b);
+    e->ahead = s;
+  }
+}/*}}}*/
+
+/**
+ * Demand access. first one on prefetched line is hit (read) or waste.
+ * (before policy access)
+ * @param cm : cache memory
+ * @param line : line
+ * @param type : READ or WRITE
+ * @return : 1 (first touch of prefetched line, skip policy access) or 0
+ */
+static inline int prefetch_demand(struct cache_mem *cm, long long line, int type)
+{/*{{{*/
+  struct cache_line *l = cache_policy[cm->policy].lookup(cm, line);
+
+  if (!l || !(l->flag & LINE_PREFETCH))
+    return 0;
+
+  l->flag &= ~LINE_PREFETCH;
+  cm->pf->pending--;
+  if (type == READ)
+    cm->pf->hit++;
+  else
+    cm->pf->waste++;
+  return 1;
+}/*}}}*/
+
+/**
+ * Prefetch stats.
+ * @param cm : cache memory
+ */
+void prefetch_stats(struct cache_mem *cm)
+{/*{{{*/
+  struct prefetch *pf = cm->pf;
+
+  printf("===== Prefetch =====\n");
+  printf("ra %ld block, stream table %d\n", pf->ra, pf->n);
+  printf("stream : sequential %ld, strided %ld\n", pf->seq, pf->strided);
+  printf("issue %ld, hit %ld (%.2f%%), waste %ld, pending %ld\n", pf->issue, pf->hit,
+      pf->issue ? 100.0 * pf->hit / pf->issue : 0, pf->waste, pf->pending);
+  printf("backend read %ld (demand miss %ld + prefetch %ld)\n",
+      cm->read - cm->hit + pf->issue, cm->read - cm->hit, pf->issue);
+}/*}}}*/
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  reuse.h
+ *         @brief:  Trace analysis. reuse distance, inter reference time, footprint.
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 23시 27분 14초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_REUSE_H
+#define __DK_REUSE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+#include "htab.h"
+#include "mrc.h"
+
+/* Log2 bucket. 0, 1, 2 ~ 3, 4 ~ 7, .. */
+#define REUSE_BUCKET 65
+
+/* Footprint sample array init size */
+#define REUSE_INIT_CAP 1024
+
+/*
+ * Block access stream is same as run_cache. (request split to blocks)
+ *   reuse distance : distinct blocks between access and last access of
+ *                    same block. (LRU stack distance of mrc.h, fenwick
+ *                    tree renumbered by footprint. O(log footprint))
+ *   irt            : block access between access and last access.
+ *   footprint      : distinct block so far, sampled every -i.
+ *   one hit wonder : block accessed only once in whole trace.
+ * Memory is footprint only. (stack + last access time per block)
+ */
+struct reuse_point
+{/*{{{*/
+  unsigned long long req;
+  double sec;                   /* trace time from first request */
+  unsigned long long access;
+  unsigned long long footprint; /* block */
+};/*}}}*/
+
+struct reuse
+{/*{{{*/
+  struct mrc m;                 /* stack. (mrc_distance) */
+  struct htab last;             /* block -> last access << 1 | reused */
+
+  unsigned long long rd[REUSE_BUCKET];
+  unsigned long long irt[REUSE_BUCKET];
+
+  unsigned long long access;
+  unsigned long long read;
+  unsigned long long write;
+  unsigned long long cold;      /* first access */
+  unsigned long long reused;    /* block accessed again */
+
+  struct reuse_point *point;    /* footprint over time */
+  unsigned long long npoint;
+  unsigned long long cap;
+};/*}}}*/
+
+/**
+ * Log2 bucket of value.
+ * @param v : distance or time
+ * @return : bucket. (0 is 0, b is 2^(b-1) ~ 2^b - 1)
+ */
+static inline int reuse_bucket(unsigned long long v)
+{/*{{{*/
+  return v ? 64 - __builtin_clzll(v) : 0;
+}/*}}}*/
+
+/**
+ * Init analysis.
+ * @param r : analysis
+ * @param block : block size (byte)
+ * @return : error code
+ */
+static int reuse_init(struct reuse *r, long block)
+{/*{{{*/
+  memset(r, 0, sizeof(struct reuse));
+  if (mrc_init(&r->m, block, MRC_INIT_CAP) < 0)
+    return -1;
+
+  r->cap = REUSE_INIT_CAP;
+  if (!(r->point = malloc(r->cap * sizeof(struct reuse_point))) ||
+      htab_init(&r->last, 1 << 16) < 0) {
+    free(r->point);
+    mrc_free(&r->m);
+    return -1;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Free analysis.
+ * @param r : analysis
+ */
+static void reuse_free(struct reuse *r)
+{/*{{{*/
+  mrc_free(&r->m);
+  htab_free(&r->last);
+  free(r->point);
+}/*}}}*/
+
+/**
+ * Access one block.
+ * @param r : analysis
+ * @param blk : block number
+ * @param type : READ or WRITE
+ * @return : error code
+ */
+static inline int reuse_access(struct reuse *r, unsigned long long blk, int type)
+{/*{{{*/
+  unsigned long long *last = NULL;
+  long long dist = mrc_distance(&r->m, blk);
+
+  if (dist == -2)
+    return -2;
+
+  r->access++;
+  if (type == READ)
+    r->read++;
+  else if (type == WRITE)
+    r->write++;
+
+  if (dist < 0) {
+    r->cold++;
+    return htab_put(&r->last, blk, r->access << 1) ? 0 : -2;
+  }
+
+  last = htab_get(&r->last, blk);
+  r->rd[reuse_bucket(dist)]++;
+  r->irt[reuse_bucket(r->access - (*last >> 1))]++;
+  if (!(*last & 1))
+    r->reused++;
+  *last = r->access << 1 | 1;
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Access request. (split to blocks like run_cache)
+ * @param r : analysis
+ * @param wl : request
+ * @return : error code
+ */
+static inline int reuse_request(struct reuse *r, struct workload *wl)
+{/*{{{*/
+  long long i = wl->offset / r->m.block;
+  long long end = (wl->offset + wl->size) / r->m.block;
+
+  for (; i <= end; i++) {
+    if (reuse_access(r, i, wl->type) < 0)
+      return -1;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Save footprint sample.
+ * @param r : analysis
+ * @param req : request so far
+ * @param sec : trace time (sec)
+ * @return : error code
+ */
+static int reuse_sample(struct reuse *r, unsigned long long req, double sec)
+{/*{{{*/
+  struct reuse_point *p = NULL;
+
+  if (r->npoint == r->cap) {
+    if (!(p = realloc(r->point, r->cap * 2 * sizeof(struct reuse_point))))
+      return -1;
+    r->point = p;
+    r->cap *= 2;
+  }
+
+  p = &r->point[r->npoint++];
+  p->req = req;
+  p->sec = sec;
+  p->access = r->access;
+  p->footprint = r->m.live;
+  return 0;
+}/*}}}*/
+
+/**
+ * Value of rank in histogram. (upper bound of bucket)
+ * @param hist : histogram
+ * @param n : number of value
+ * @param q : 0 ~ 1
+ * @return : value
+ */
+static unsigned long long reuse_quantile(unsigned long long *hist, unsigned long long n, double q)
+{/*{{{*/
+  unsigned long long sum = 0;
+  int b = 0;
+
+  for (b = 0; b < REUSE_BUCKET; b++) {
+    sum += hist[b];
+    if (sum && sum >= q * n)
+      return b ? (1ULL << b) - 1 : 0;
+  }
+  return 0;
+}/*}}}*/
+
+/**
+ * Print analysis. summary table and result.dat
+ * result.dat index 0 : reuse distance, irt (% of reuse) per bucket
+ *            index 1 : footprint (MB) over request
+ * @param r : analysis array
+ * @param n : number of block size
+ * @param out : result.dat output or NULL
+ */
+static void reuse_report(struct reuse *r, int n, FILE *out)
+{/*{{{*/
+  struct reuse *e = NULL;
+  char name[32];
+  unsigned long long re = 0, k = 0;
+  int i = 0, b = 0, max = 0;
+
+  printf("========== reuse ==========\n");
+  printf("%6s %12s %12s %12s %12s %10s %12s %8s %10s %10s %10s %10s\n", "block", "access",
+      "read", "write", "footprint", "(MB)", "one_hit", "(%)", "rd_p50", "rd_p90", "irt_p50",
+      "irt_p90");
+  for (i = 0; i < n; i++) {
+    e = &r[i];
+    re = e->access - e->cold;
+    printf("%5ldK %12llu %12llu %12llu %12llu %10.1f %12llu %8.3f %10llu %10llu %10llu %10llu\n",
+        e->m.block / KB, e->access, e->read, e->write, e->m.live,
+        (double)e->m.live * e->m.block / MB, e->m.live - e->reused,
+        e->m.live ? 100.0 * (e->m.live - e->reused) / e->m.live : 0,
+        reuse_quantile(e->rd, re, 0.5), reuse_quantile(e->rd, re, 0.9),
+        reuse_quantile(e->irt, re, 0.5), reuse_quantile(e->irt, re, 0.9));
+
+    for (b = 0; b < REUSE_BUCKET; b++) {
+      if (e->rd[b] || e->irt[b])
+        max = MAX(max, b);
+    }
+  }
+
+  /* Histogram. % of reuse (cold access is not reuse) */
+  printf("%12s", "bucket");
+  for (i = 0; i < n; i++) {
+    snprintf(name, sizeof(name), "rd-%ldK", r[i].m.block / KB);
+    printf("  %11s", name);
+    snprintf(name, sizeof(name), "irt-%ldK", r[i].m.block / KB);
+    printf(" %11s", name);
+  }
+  printf("\n");
+  for (b = 0; b <= max; b++) {
+    printf("%12llu", b ? 1ULL << (b - 1) : 0);
+    for (i = 0; i < n; i++) {
+      re = r[i].access - r[i].cold;
+      printf("  %11.3f %11.3f", re ? 100.0 * r[i].rd[b] / re : 0,
+          re ? 100.0 * r[i].irt[b] / re : 0);
+    }
+    printf("\n");
+  }
+  printf("========== reuse ==========\n");
+
+  if (!out)
+    return;
+
+  fprintf(out, "Bucket");
+  for (i = 0; i < n; i++)
+    fprintf(out, "  RD-%ldK  IRT-%ldK", r[i].m.block / KB, r[i].m.block / KB);
+  fprintf(out, "\n");
+  for (b = 0; b <= max; b++) {
+    fprintf(out, "%llu", b ? 1ULL << (b - 1) : 0);
+    for (i = 0; i < n; i++) {
+      re = r[i].access - r[i].cold;
+      fprintf(out, "  %.3f  %.3f", re ? 100.0 * r[i].rd[b] / re : 0,
+          re ? 100.0 * r[i].irt[b] / re : 0);
+    }
+    fprintf(out, "\n");
+  }
+
+  /* Every block size has same sample point */
+  fprintf(out, "\n\nRequest  Time");
+  for (i = 0; i < n; i++)
+    fprintf(out, "  FP-%ldK", r[i].m.block / KB);
+  fprintf(out, "\n");
+  for (k = 0; k < r[0].npoint; k++) {
+    fprintf(out, "%llu  %.3f", r[0].point[k].req, r[0].point[k].sec);
+    for (i = 0; i < n; i++)
+      fprintf(out, "  %.3f", (double)r[i].point[k].footprint * r[i].m.block / MB);
+    fprintf(out, "\n");
+  }
+}/*}}}*/
+
+/**
+ * Reuse main. one pass for every block size.
+ * @param t : trace
+ * @param block : block size array (byte)
+ * @param n : number of block size
+ * @param step : footprint sample every step request (0 is off)
+ * @param span : footprint sample every span trace tick (0 is off)
+ * @param out : result.dat output or NULL
+ * @return : error code
+ */
+int run_reuse(struct trace *t, long *block, int n, long step, unsigned long long span, FILE *out)
+{/*{{{*/
+  struct reuse *r = NULL;
+  struct workload wl;
+  unsigned long long req = 0, start = 0, next = 0, now = 0;
+  int i = 0, ninit = 0, ret = 0, sample = 0;
+
+  /* NULL arg */
+  if (!t || !block || n <= 0) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(r = calloc(n, sizeof(struct reuse))))
+    return -2;
+
+  for (ninit = 0; ninit < n; ninit++) {
+    if (reuse_init(&r[ninit], block[ninit]) < 0) {
+      ret = -2;
+      goto end;
+    }
+  }
+
+  while ((ret = trace_next(t, &wl)) == 1) {
+    /* Sample before request of next window. (window.h) */
+    if (!req) {
+      start = wl.time;
+      next = wl.time + span;
+    } else {
+      sample = step && req % step == 0;
+      if (span && wl.time >= next) {
+        sample = 1;
+        next += ((wl.time - next) / span + 1) * span;
+      }
+      for (i = 0; sample && i < n; i++) {
+        if (reuse_sample(&r[i], req, (double)(now - start) / TRACE_TICK_SEC) < 0) {
+          ret = -2;
+          goto end;
+        }
+      }
+    }
+
+    for (i = 0; i < n; i++) {
+      if (reuse_request(&r[i], &wl) < 0) {
+        ret = -2;
+        goto end;
+      }
+    }
+    req++;
+    now = wl.time;
+  }
+
+  /* Bad trace line */
+  if (ret < 0)
+    goto end;
+
+  /* Last point */
+  for (i = 0; i < n; i++) {
+    if ((!r[i].npoint || r[i].point[r[i].npoint - 1].req < req) &&
+        reuse_sample(&r[i], req, (double)(now - start) / TRACE_TICK_SEC) < 0) {
+      ret = -2;
+      goto end;
+    }
+  }
+
+  reuse_report(r, n, out);
+
+end:
+  for (i = 0; i < ninit; i++)
+    reuse_free(&r[i]);
+  free(r);
+
+  return ret;
+}/*}}}*/
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  sarc.h
+ *         @brief:  Sharded ARC. thread safe ARC cache for multi thread service.
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 15시 12분 44초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_SARC_H
+#define __DK_SARC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "hash.h"
+
+/* Default shard count */
+#define SARC_SHARD 64
+
+/* Contention bench */
+#define SARC_BENCH_OPS (1 << 20)    /* ops per thread */
+#define SARC_BENCH_MAX_THREAD 64
+
+/*
+ * Each shard is a whole ARC (mru/mfu/ghost lists, hash, slab) behind its
+ * own lock. A key always goes to the same shard, so ARC state is never
+ * shared between locks.
+ */
+struct sarc_shard
+{/*{{{*/
+  pthread_mutex_t lock;
+  struct cache_mem *cm;
+  long hit;
+  long miss;
+} __attribute__((aligned(64)));/*}}}*/
+
+struct sarc
+{/*{{{*/
+  int nshard;               /* 2^bits */
+  int nlock;                /* shard of initialized lock */
+  unsigned int bits;
+  struct sarc_shard *shard;
+};/*}}}*/
+
+/**
+ * Shard of key.
+ * Use mix_64, not hash_64. hash_64 top bits select bucket in the shard.
+ * @param s : sharded arc
+ * @param key : key
+ * @return : shard
+ */
+static inline struct sarc_shard *sarc_shard(struct sarc *s, long long key)
+{/*{{{*/
+  return &s->shard[s->bits ? mix_64(key) >> (64 - s->bits) : 0];
+}/*}}}*/
+
+/**
+ * Free sharded arc. (release callback is called for resident data)
+ * @param s : sharded arc
+ */
+void sarc_free(struct sarc *s)
+{/*{{{*/
+  struct list_head *tmp = NULL;
+  struct cache_line *l = NULL;
+  struct cache_mem *cm = NULL;
+  int i = 0;
+
+  if (!s)
+    return;
+
+  for (i = 0; i < s->nlock; i++)
+    pthread_mutex_destroy(&s->shard[i].lock);
+
+  for (i = 0; i < s->nshard; i++) {
+    if (!(cm = s->shard[i].cm))
+      continue;
+
+    if (cm->release) {
+      list_each(tmp, &cm->mru.head) {
+        l = list_entry(tmp, struct cache_line, head);
+        if (l->data)
+          cm->release(l->data);
+      }
+      list_each(tmp, &cm->mfu.head) {
+        l = list_entry(tmp, struct cache_line, head);
+        if (l->data)
+          cm->release(l->data);
+      }
+    }
+
+    del_cm(cm);
+  }
+
+  free(s->shard);
+  free(s);
+}/*}}}*/
+
+/**
+ * Init sharded arc.
+ * @param c : cache size (line). split to shards
+ * @param nshard : number of shard (round up to 2^n)
+ * @param release : called when line data leaves cache. (NULL is ok)
+ * @return : sharded arc or NULL
+ */
+struct sarc *sarc_init(long c, int nshard, void (*release)(void *data))
+{/*{{{*/
+  struct sarc *s = NULL;
+  int i = 0;
+
+  if (c <= 0 || nshard <= 0)
+    return NULL;
+
+  if (!(s = calloc(1, sizeof(struct sarc))))
+    return NULL;
+
+  s->bits = nshard > 1 ? hash_bits(nshard) : 0;
+  s->nshard = 1 << s->bits;
+  if (posix_memalign((void **)&s->shard, 64, s->nshard * sizeof(struct sarc_shard))) {
+    free(s);
+    return NULL;
+  }
+  memset(s->shard, 0, s->nshard * sizeof(struct sarc_shard));
+
+  for (i = 0; i < s->nshard; i++) {
+    if (pthread_mutex_init(&s->shard[i].lock, NULL) != 0) {
+      sarc_free(s);
+      return NULL;
+    }
+    s->nlock++;
+
+    s->shard[i].cm = init_cache_mem(MAX(c / s->nshard, 1));
+    if (!s->shard[i].cm) {
+      sarc_free(s);
+      return NULL;
+    }
+    s->shard[i].cm->release = release;
+  }
+
+  return s;
+}/*}}}*/
+
+/**
+ * Get key. miss inserts key without data. (sarc_set later)
+ * Key must be 0 or more. ARC line is not negative. (ARC_lookup)
+ * @param s : sharded arc
+ * @param key : key
+ * @param data : saved data of hit line (NULL is ok)
+ * @return : 1 (hit), 0 (miss), -1 (negative key)
+ */
+int sarc_get(struct sarc *s, long long key, void **data)
+{/*{{{*/
+  struct sarc_shard *sh = NULL;
+  struct cache_line *l = NULL;
+
+  if (key < 0) {
+    printf("[FAIL] negative key %lld, %s \n", key, __func__);
+    return -1;
+  }
+
+  sh = sarc_shard(s, key);
+  pthread_mutex_lock(&sh->lock);
+
+  l = ARC_cache(sh->cm, key);
+  if (l) {
+    sh->hit++;
+    if (data)
+      *data = l->data;
+  } else {
+    sh->miss++;
+  }
+
+  pthread_mutex_unlock(&sh->lock);
+  return l != NULL;
+}/*}}}*/
+
+/**
+ * Set data of resident key.
+ * Old data is released. data is released when line leaves cache.
+ * @param s : sharded arc
+ * @param key : key
+ * @param data : data
+ * @return : 1 (set), 0 (not resident. data is not kept), -1 (negative key)
+ */
+int sarc_set(struct sarc *s, long long key, void *data)
+{/*{{{*/
+  struct sarc_shard *sh = NULL;
+  struct cache_line *l = NULL;
+  int ret = 0;
+
+  if (key < 0) {
+    printf("[FAIL] negative key %lld, %s \n", key, __func__);
+    return -1;
+  }
+
+  sh = sarc_shard(s, key);
+  pthread_mutex_lock(&sh->lock);
+
+  l = ARC_lookup(sh->cm, key);
+  if (l && (l->state == &sh->cm->mru || l->state == &sh->cm->mfu)) {
+    if (l->data && l->data != data && sh->cm->release)
+      sh->cm->release(l->data);
+    l->data = data;
+    ret = 1;
+  }
+
+  pthread_mutex_unlock(&sh->lock);
+  return ret;
+}/*}}}*/
+
+/**
+ * Sum of shard counter.
+ * @param s : sharded arc
+ * @param hit : saved hit
+ * @param miss : saved miss
+ */
+void sarc_stat(struct sarc *s, long *hit, long *miss)
+{/*{{{*/
+  int i = 0;
+
+  *hit = *miss = 0;
+  for (i = 0; i < s->nshard; i++) {
+    pthread_mutex_lock(&s->shard[i].lock);
+    *hit += s->shard[i].hit;
+    *miss += s->shard[i].miss;
+    pthread_mutex_unlock(&s->shard[i].lock);
+  }
+}/*}}}*/
+
+struct sarc_bench
+{/*{{{*/
+  struct sarc *s;
+  long long keys;           /* key space */
+  unsigned long long seed;
+  long ops;
+};/*}}}*/
+
+/**
+ * Bench thread. skewed random key. (small key is hot)
+ * @param arg : sarc_bench
+ * @return : NULL
+ */
+static void *sarc_bench_worker(void *arg)
+{/*{{{*/
+  struct sarc_bench *b = arg;
+  unsigned long long x = b->seed;
+  long long key = 0;
+  long i = 0;
+
+  for (i = 0; i < b->ops; i++) {
+    /* xorshift64 */
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+
+    key = x % b->keys;
+    key = (x >> 32) % (key + 1);
+    if (sarc_get(b->s, key, NULL) == 0)
+      sarc_set(b->s, key, NULL);
+  }
+
+  return NULL;
+}/*}}}*/
+
+/**
+ * Contention bench. 1, 2, 4 .. max thread on one sharded arc.
+ * @param c : cache size (line)
+ * @param nshard : number of shard
+ * @param max : max thread
+ * @return : error code
+ */
+int run_sarc_bench(long c, int nshard, int max)
+{/*{{{*/
+  struct sarc_bench b[SARC_BENCH_MAX_THREAD];
+  pthread_t tid[SARC_BENCH_MAX_THREAD];
+  struct sarc *s = NULL;
+  struct timespec st, et;
+  long hit = 0, miss = 0;
+  double sec = 0;
+  int n = 0, i = 0;
+
+  max = MAX(1, MIN(max, SARC_BENCH_MAX_THREAD));
+
+  printf("===== sharded arc bench : cache %ld line, %d shard, %d op/thread =====\n",
+      c, nshard, SARC_BENCH_OPS);
+  printf("%7s %12s %10s %8s\n", "thread", "ops/sec", "sec", "hit(%)");
+
+  for (n = 1; ; n = MIN(n * 2, max)) {
+    if (!(s = sarc_init(c, nshard, NULL)))
+      return -2;
+
+    clock_gettime(CLOCK_MONOTONIC, &st);
+    for (i = 0; i < n; i++) {
+      b[i].s = s;
+      b[i].keys = c * 4;
+      b[i].seed = 0x9e3779b97f4a7c15ULL * (i + 1);
+      b[i].ops = SARC_BENCH_OPS;
+      if (pthread_create(&tid[i], NULL, sarc_bench_worker, &b[i]) != 0)
+        break;
+    }
+    n = i;
+    for (i = 0; i < n; i++)
+      pthread_join(tid[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &et);
+
+    sec = (et.tv_sec - st.tv_sec) + (et.tv_nsec - st.tv_nsec) / 1e9;
+    sarc_stat(s, &hit, &miss);
+    printf("%7d %12.0f %10.3f %8.3f\n", n, (double)n * SARC_BENCH_OPS / sec, sec,
+        hit + miss ? 100.0 * hit / (hit + miss) : 0);
+
+    sarc_free(s);
+    if (n >= max || n == 0)
+      break;
+  }
+
+  return 0;
+}/*}}}*/
+
+#endif
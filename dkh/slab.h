@@ -0,0 +1,159 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  slab.h
+ *         @brief:  Fixed size object pool. (preallocated chunk + free list)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 13시 48분 12초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_SLAB_H
+#define __DK_SLAB_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Chunk header. objects follow it */
+struct slab_chunk
+{/*{{{*/
+  struct slab_chunk *next;
+  unsigned long n;
+};/*}}}*/
+
+struct slab
+{/*{{{*/
+  size_t size;                /* object size */
+  unsigned long n;            /* objects per chunk */
+
+  struct slab_chunk *chunk;   /* chunk list */
+  unsigned long nchunk;
+  unsigned long bump;         /* next unused object of first chunk */
+
+  void *free;                 /* free list (link in object) */
+
+  unsigned long used;
+  unsigned long peak;
+  unsigned long cap;
+};/*}}}*/
+
+/**
+ * Add chunk.
+ * @param s : slab
+ * @param n : number of object
+ * @return : error code
+ */
+static int slab_grow(struct slab *s, unsigned long n)
+{/*{{{*/
+  struct slab_chunk *c = NULL;
+
+  if (!(c = malloc(sizeof(struct slab_chunk) + n * s->size)))
+    return -1;
+
+  c->n = n;
+  c->next = s->chunk;
+  s->chunk = c;
+  s->nchunk++;
+  s->bump = 0;
+  s->cap += n;
+  return 0;
+}/*}}}*/
+
+/**
+ * Init slab. first chunk is allocated now.
+ * @param s : slab
+ * @param size : object size
+ * @param n : number of object. (expected max)
+ * @return : error code
+ */
+static int slab_init(struct slab *s, size_t size, unsigned long n)
+{/*{{{*/
+  memset(s, 0, sizeof(struct slab));
+
+  /* free list link is saved in object */
+  s->size = MAX(size, sizeof(void *));
+  s->size = (s->size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+  s->n = MAX(n, 1);
+
+  return slab_grow(s, s->n);
+}/*}}}*/
+
+/**
+ * Alloc object.
+ * @param s : slab
+ * @return : object or NULL
+ */
+static inline void *slab_alloc(struct slab *s)
+{/*{{{*/
+  void *p = NULL;
+
+  if (s->free) {
+    p = s->free;
+    s->free = *(void **)p;
+  } else {
+    /* Full. grow by half of first size */
+    if (s->bump == s->chunk->n && slab_grow(s, MAX(s->n >> 1, 1)) < 0)
+      return NULL;
+
+    p = (char *)(s->chunk + 1) + s->bump * s->size;
+    s->bump++;
+  }
+
+  s->used++;
+  if (s->used > s->peak)
+    s->peak = s->used;
+  return p;
+}/*}}}*/
+
+/**
+ * Free object. (back to free list)
+ * @param s : slab
+ * @param p : object
+ */
+static inline void slab_free(struct slab *s, void *p)
+{/*{{{*/
+  *(void **)p = s->free;
+  s->free = p;
+  s->used--;
+}/*}}}*/
+
+/**
+ * Free all object and chunk at once.
+ * @param s : slab
+ */
+static void slab_destroy(struct slab *s)
+{/*{{{*/
+  struct slab_chunk *c = NULL;
+
+  while ((c = s->chunk)) {
+    s->chunk = c->next;
+    free(c);
+  }
+
+  s->free = NULL;
+  s->nchunk = s->cap = s->used = s->bump = 0;
+}/*}}}*/
+
+/**
+ * Print pool usage.
+ * @param s : slab
+ * @param name : object name
+ */
+static void slab_report(struct slab *s, char *name)
+{/*{{{*/
+  unsigned long long bytes = s->nchunk * sizeof(struct slab_chunk) +
+    (unsigned long long)s->cap * s->size;
+
+  printf("Slab %s : object %zu byte, used %lu, peak %lu, cap %lu, chunk %lu\n",
+      name, s->size, s->used, s->peak, s->cap, s->nchunk);
+  printf("Slab %s : %llu byte, %.2f byte/peak entry\n", name, bytes,
+      s->peak ? (double)bytes / s->peak : 0);
+}/*}}}*/
+
+#endif
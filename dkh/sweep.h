@@ -0,0 +1,497 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  sweep.h
+ *         @brief:  Parameter sweep. many cache_mem on one shared trace. (pthread)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 14시 30분 27초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_SWEEP_H
+#define __DK_SWEEP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include "trace.h"
+
+/* Max cache size / block size / policy count */
+#define SWEEP_MAX_SIZE 64
+#define SWEEP_MAX_BLOCK 8
+#define SWEEP_MAX_POLICY POLICY_NUM
+#define SWEEP_MAX_THREAD 256
+
+/* Mini simulation. default size per octave (1MB ~ 512MB) */
+#define SWEEP_MINI_STEP 4
+
+/* One cache instance */
+struct sweep_job
+{/*{{{*/
+  long size;                /* cache size (byte) */
+  long block;               /* block size (byte) */
+  int seed;                 /* mini sample seed */
+  struct cache_opt opt;     /* policy and parameter */
+
+  /* mini simulation. sampled stream of block size (shared, read only) */
+  unsigned long long *sample;
+  unsigned long long nsample;
+  long c;                   /* scaled cache size (block) */
+
+  long read;
+  long write;
+  long hit;
+
+  struct req_stat rreq, wreq;
+
+  /* read request latency (-x lat=) */
+  double lat_mean, lat_base;
+  double p50, p99, p999;
+
+  double sec;
+  int ret;
+};/*}}}*/
+
+/*
+ * Mini simulation (Waldspurger et al., ATC 17)
+ * Block is sampled iff hash(block) < rate. Cache of size c runs as
+ * c * rate lines on sampled stream. Hit ratio needs no rescale.
+ * Stream is sampled once per block size and seed, shared by every cache
+ * of them. one sampled access is (block << 2 | type).
+ * One sample is biased by its hot blocks, so SHARDS_SEED seeds run and
+ * report mean and stddev like run_shards.
+ */
+struct sweep
+{/*{{{*/
+  /* shared trace. read only */
+  struct trace_rec *rec;
+  unsigned long long count;
+  double rate;              /* 1 is full run */
+  int nseed;                /* 1 or SHARDS_SEED (mini) */
+  int npolicy;
+
+  struct sweep_job *job;
+  int njob;
+  int next;                 /* next job (atomic) */
+};/*}}}*/
+
+/**
+ * Run one cache instance over whole trace.
+ * @param sw : sweep
+ * @param job : job
+ */
+static void sweep_run_job(struct sweep *sw, struct sweep_job *job)
+{/*{{{*/
+  struct cache_mem *cm = NULL;
+  struct workload wl;
+  struct timespec s, e;
+  unsigned long long i = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &s);
+
+  if (!(cm = init_cache_mem(job->c))) {
+    job->ret = -2;
+    return;
+  }
+  cm->block = job->block;
+  if (set_policy(cm, &job->opt) < 0 ||
+      (cm->tn && tenant_scan(cm, sw->rec, sw->count) < 0)) {
+    del_cm(cm);
+    job->ret = -1;
+    return;
+  }
+
+  if (job->sample) {
+    /* one block request */
+    memset(&wl, 0, sizeof(wl));
+    for (i = 0; i < job->nsample; i++) {
+      wl.offset = (job->sample[i] >> 2) * job->block;
+      wl.type = job->sample[i] & 3;
+      run_cache(cm, &wl);
+    }
+  } else {
+    for (i = 0; i < sw->count; i++) {
+      trace_rec_load(&sw->rec[i], &wl);
+      run_cache(cm, &wl);
+    }
+  }
+
+  job->read = cm->read;
+  job->write = cm->write;
+  job->hit = cm->hit;
+  job->rreq = cm->rreq;
+  job->wreq = cm->wreq;
+  if (cm->lat) {
+    job->lat_mean = lat_mean(cm->lat);
+    job->lat_base = cm->lat->n ? cm->lat->base / cm->lat->n : 0;
+    job->p50 = lat_quantile(cm->lat, 0.5);
+    job->p99 = lat_quantile(cm->lat, 0.99);
+    job->p999 = lat_quantile(cm->lat, 0.999);
+  }
+  del_cm(cm);
+
+  clock_gettime(CLOCK_MONOTONIC, &e);
+  job->sec = (e.tv_sec - s.tv_sec) + (e.tv_nsec - s.tv_nsec) / 1e9;
+}/*}}}*/
+
+/**
+ * Sampled block stream of block size.
+ * @param sw : sweep
+ * @param block : block size (byte)
+ * @param seed : seed number (same hash as shards_hash)
+ * @param n : saved number of sampled access
+ * @return : stream or NULL
+ */
+static unsigned long long *sweep_sample(struct sweep *sw, long block, int seed,
+    unsigned long long *n)
+{/*{{{*/
+  unsigned long long t = MAX((unsigned long long)(sw->rate * SHARDS_MOD), 1);
+  unsigned long long h = mix_64(seed + 1);
+  unsigned long long *sample = NULL, *tmp = NULL;
+  unsigned long long i = 0, cap = 1 << 16;
+  long long b = 0, end = 0;
+
+  if (!(sample = malloc(cap * sizeof(unsigned long long))))
+    return NULL;
+
+  *n = 0;
+  for (i = 0; i < sw->count; i++) {
+    end = (sw->rec[i].offset + sw->rec[i].size) / block;
+    for (b = sw->rec[i].offset / block; b <= end; b++) {
+      if ((mix_64(b ^ h) & (SHARDS_MOD - 1)) >= t)
+        continue;
+
+      if (*n == cap) {
+        if (!(tmp = realloc(sample, cap * 2 * sizeof(unsigned long long)))) {
+          free(sample);
+          return NULL;
+        }
+        sample = tmp;
+        cap *= 2;
+      }
+      sample[(*n)++] = (unsigned long long)b << 2 | sw->rec[i].type;
+    }
+  }
+
+  return sample;
+}/*}}}*/
+
+/**
+ * Worker thread. take job until empty.
+ * @param arg : sweep
+ * @return : NULL
+ */
+static void *sweep_worker(void *arg)
+{/*{{{*/
+  struct sweep *sw = arg;
+  int i = 0;
+
+  while ((i = __sync_fetch_and_add(&sw->next, 1)) < sw->njob)
+    sweep_run_job(sw, &sw->job[i]);
+
+  return NULL;
+}/*}}}*/
+
+/**
+ * Ratio of result.dat index.
+ * @param job : job
+ * @param k : 0 (block), 1 (read request full hit), 2 (read byte)
+ * @return : ratio (%)
+ */
+static double sweep_ratio(struct sweep_job *job, int k)
+{/*{{{*/
+  switch (k) {
+    case 1 : return job->rreq.req ? 100.0 * job->rreq.full / job->rreq.req : 0;
+    case 2 : return job->rreq.byte ? 100.0 * job->rreq.hit_byte / job->rreq.byte : 0;
+  }
+  return job->read ? 100.0 * job->hit / job->read : 0;
+}/*}}}*/
+
+/**
+ * Mean and stddev of seeds. (mini)
+ * @param job : first job of seeds
+ * @param nseed : number of seed
+ * @param sd : saved stddev
+ * @return : mean of block hit ratio (%)
+ */
+static double sweep_mean(struct sweep_job *job, int nseed, double *sd)
+{/*{{{*/
+  double r = 0, sum = 0, sq = 0, mean = 0;
+  int k = 0, n = 0;
+
+  for (k = 0; k < nseed; k++) {
+    if (job[k].ret < 0)
+      continue;
+    r = sweep_ratio(&job[k], 0);
+    sum += r;
+    sq += r * r;
+    n++;
+  }
+
+  mean = n ? sum / n : 0;
+  *sd = n ? sqrt(MAX(0, sq / n - mean * mean)) : 0;
+  return mean;
+}/*}}}*/
+
+/**
+ * Column name of result.dat. policy is in name if more than one.
+ * @param sw : sweep
+ * @param job : first job of column
+ * @param out : result.dat output
+ */
+static void sweep_column(struct sweep *sw, struct sweep_job *job, FILE *out)
+{/*{{{*/
+  if (sw->npolicy > 1)
+    fprintf(out, "%s-", cache_policy[job->opt.policy].name);
+  fprintf(out, "%ldK", job->block / KB);
+}/*}}}*/
+
+/**
+ * Print combined report. table and result.dat (gnu/result_*)
+ * result.dat index 0 : block hit ratio
+ *            index 1 : read request full hit ratio
+ *            index 2 : read byte hit ratio
+ * Column is block size of each policy. (policy-block if -p is a list)
+ * mini result.dat is mean and stddev column per block size. (gnu/result_shards)
+ * Request of sampled stream is one block, so mini has no request level.
+ * @param sw : sweep
+ * @param nsize : number of cache size
+ * @param nblock : number of block size
+ * @param out : result.dat output or NULL
+ */
+static void sweep_report(struct sweep *sw, int nsize, int nblock, FILE *out)
+{/*{{{*/
+  static char *name[] = {"", "req-", "byte-"};
+  struct sweep_job *job = NULL;
+  double mean = 0, sd = 0;
+  int i = 0, j = 0, k = 0, p = 0;
+  int ncol = sw->npolicy * nblock;
+
+  printf("========== sweep ==========\n");
+  printf("%10s %6s %6s %4s %10s %12s %12s %8s %12s %8s %12s\n", "size(MB)", "block",
+      "policy", "seed", "line", "hit", "read", "ratio", "write", "sec", "block/sec");
+  for (i = 0; i < sw->njob; i++) {
+    job = &sw->job[i];
+    if (job->ret < 0) {
+      printf("%10.2f %5ldK %6s %4d FAIL(%d)\n", (double)job->size / MB, job->block / KB,
+          cache_policy[job->opt.policy].name, job->seed, job->ret);
+      continue;
+    }
+
+    printf("%10.2f %5ldK %6s %4d %10ld %12ld %12ld %8.3f %12ld %8.2f %12.0f\n",
+        (double)job->size / MB, job->block / KB, cache_policy[job->opt.policy].name,
+        job->seed, job->c, job->hit, job->read,
+        job->read ? 100.0 * job->hit / job->read : 0, job->write, job->sec,
+        job->sec > 0 ? (job->read + job->write) / job->sec : 0);
+  }
+  printf("========== sweep ==========\n");
+
+  if (sw->nseed > 1) {
+    printf("========== mini ==========\n");
+    printf("%10s %6s %6s %8s %8s\n", "size(MB)", "block", "policy", "mean", "sd");
+    for (i = 0; i < sw->njob; i += sw->nseed) {
+      job = &sw->job[i];
+      mean = sweep_mean(job, sw->nseed, &sd);
+      printf("%10.2f %5ldK %6s %8.3f %8.3f\n", (double)job->size / MB, job->block / KB,
+          cache_policy[job->opt.policy].name, mean, sd);
+    }
+    printf("========== mini ==========\n");
+
+    if (!out)
+      return;
+
+    /* row : log2(size), column : mean, sd of policy, block size */
+    fprintf(out, "Size");
+    for (j = 0; j < ncol; j++) {
+      fprintf(out, "  ");
+      sweep_column(sw, &sw->job[(j / nblock * nsize * nblock + j % nblock) * sw->nseed], out);
+      fprintf(out, "  sd");
+    }
+    fprintf(out, "\n");
+
+    for (i = 0; i < nsize; i++) {
+      fprintf(out, "%g", log2(sw->job[i * nblock * sw->nseed].size));
+      for (p = 0; p < sw->npolicy; p++) {
+        job = &sw->job[((p * nsize + i) * nblock) * sw->nseed];
+        for (j = 0; j < nblock; j++, job += sw->nseed) {
+          mean = sweep_mean(job, sw->nseed, &sd);
+          fprintf(out, "  %.3f  %.3f", mean, sd);
+        }
+      }
+      fprintf(out, "\n");
+    }
+    return;
+  }
+
+  /* request level. full hit, partial hit, byte hit ratio (%), saved read I/O */
+  printf("========== request ==========\n");
+  printf("%10s %6s %6s %8s %8s %8s %8s %8s %8s %12s\n", "size(MB)", "block", "policy",
+      "r_full", "r_part", "r_byte", "w_full", "w_part", "w_byte", "r_io_saved");
+  for (i = 0; i < sw->njob; i++) {
+    job = &sw->job[i];
+    if (job->ret < 0)
+      continue;
+    printf("%10.2f %5ldK %6s %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %12ld\n",
+        (double)job->size / MB, job->block / KB, cache_policy[job->opt.policy].name,
+        job->rreq.req ? 100.0 * job->rreq.full / job->rreq.req : 0,
+        job->rreq.req ? 100.0 * job->rreq.partial / job->rreq.req : 0,
+        job->rreq.byte ? 100.0 * job->rreq.hit_byte / job->rreq.byte : 0,
+        job->wreq.req ? 100.0 * job->wreq.full / job->wreq.req : 0,
+        job->wreq.req ? 100.0 * job->wreq.partial / job->wreq.req : 0,
+        job->wreq.byte ? 100.0 * job->wreq.hit_byte / job->wreq.byte : 0,
+        job->rreq.full);
+  }
+  printf("========== request ==========\n");
+
+  if (sw->njob && sw->job[0].opt.lat >= 0) {
+    printf("%10s %6s %6s %10s %10s %10s %10s %10s\n", "size(MB)", "block", "policy",
+        "mean", "no cache", "p50", "p99", "p999");
+    for (i = 0; i < sw->njob; i++) {
+      job = &sw->job[i];
+      if (job->ret < 0)
+        continue;
+      printf("%10.2f %5ldK %6s %10.1f %10.1f %10.0f %10.0f %10.0f\n", (double)job->size / MB,
+          job->block / KB, cache_policy[job->opt.policy].name, job->lat_mean, job->lat_base,
+          job->p50, job->p99, job->p999);
+    }
+    printf("========== latency ==========\n");
+  }
+
+  if (!out)
+    return;
+
+  /* row : log2(size), column : policy, block size */
+  for (k = 0; k < 3; k++) {
+    fprintf(out, k ? "\n\nSize" : "Size");
+    for (j = 0; j < ncol; j++) {
+      fprintf(out, "  %s", name[k]);
+      sweep_column(sw, &sw->job[j / nblock * nsize * nblock + j % nblock], out);
+    }
+    fprintf(out, "\n");
+
+    for (i = 0; i < nsize; i++) {
+      fprintf(out, "%g", log2(sw->job[i * nblock].size));
+      for (p = 0; p < sw->npolicy; p++) {
+        job = &sw->job[(p * nsize + i) * nblock];
+        for (j = 0; j < nblock; j++, job++)
+          fprintf(out, "  %.3f", sweep_ratio(job, k));
+      }
+      fprintf(out, "\n");
+    }
+  }
+}/*}}}*/
+
+/**
+ * Sweep main. trace is parsed (or mapped) once and shared by all workers.
+ * @param t : trace
+ * @param size : cache size array (byte)
+ * @param nsize : number of cache size
+ * @param block : block size array (byte)
+ * @param nblock : number of block size
+ * @param policy : policy array (POLICY_*)
+ * @param npolicy : number of policy
+ * @param opt : parameter (policy is from policy array)
+ * @param rate : mini simulation sample rate. (1 is full run)
+ * @param nthread : number of worker. (0 is number of cpu)
+ * @param out : result.dat output or NULL
+ * @return : error code
+ */
+int run_sweep(struct trace *t, long *size, int nsize, long *block, int nblock,
+    int *policy, int npolicy, struct cache_opt *opt, double rate, int nthread, FILE *out)
+{/*{{{*/
+  struct sweep sw;
+  struct sweep_job *job = NULL;
+  pthread_t tid[SWEEP_MAX_THREAD];
+  unsigned long long *sample[SWEEP_MAX_BLOCK * SHARDS_SEED] = {NULL, };
+  unsigned long long nsample[SWEEP_MAX_BLOCK * SHARDS_SEED] = {0, };
+  int i = 0, j = 0, k = 0, p = 0, ret = 0;
+
+  /* NULL arg */
+  if (!t || !size || !block || !policy || !opt || nsize <= 0 || nblock <= 0 ||
+      npolicy <= 0 || rate <= 0 || rate > 1) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  /* Sampled stream has no host, disk */
+  if (rate < 1 && opt->tenant != TENANT_OFF) {
+    printf("[FAIL] mini does not run with tenant, %s \n", __func__);
+    return -1;
+  }
+
+  memset(&sw, 0, sizeof(sw));
+  sw.rate = rate;
+  sw.nseed = rate < 1 ? SHARDS_SEED : 1;
+  sw.npolicy = npolicy;
+  if (!(sw.rec = trace_records(t, &sw.count)))
+    return -2;
+
+  /* job of (policy, size, block, seed) */
+  sw.njob = npolicy * nsize * nblock * sw.nseed;
+  if (!(sw.job = calloc(sw.njob, sizeof(struct sweep_job))))
+    return -2;
+
+  for (j = 0; rate < 1 && j < nblock * sw.nseed; j++) {
+    k = j % sw.nseed;
+    if (!(sample[j] = sweep_sample(&sw, block[j / sw.nseed], k, &nsample[j]))) {
+      ret = -2;
+      goto end;
+    }
+    printf("mini : %ldK block, rate %g, seed %d, %llu sampled access\n",
+        block[j / sw.nseed] / KB, rate, k, nsample[j]);
+  }
+
+  /* Sampled stream is shared by every policy and size */
+  for (p = 0; p < npolicy; p++) {
+    for (i = 0; i < nsize; i++) {
+      for (j = 0; j < nblock * sw.nseed; j++) {
+        job = &sw.job[(p * nsize + i) * nblock * sw.nseed + j];
+        job->size = size[i];
+        job->block = block[j / sw.nseed];
+        job->seed = j % sw.nseed;
+        job->opt = *opt;
+        job->opt.policy = policy[p];
+        job->sample = sample[j];
+        job->nsample = nsample[j];
+        job->c = rate < 1 ? MAX(1, llround(size[i] / job->block * rate)) : size[i] / job->block;
+      }
+    }
+  }
+
+  if (nthread <= 0)
+    nthread = sysconf(_SC_NPROCESSORS_ONLN);
+  nthread = MAX(1, MIN(nthread, MIN(sw.njob, SWEEP_MAX_THREAD)));
+
+  printf("sweep : %llu requests, %d caches, %d threads\n", sw.count, sw.njob, nthread);
+
+  for (i = 0; i < nthread; i++) {
+    if (pthread_create(&tid[i], NULL, sweep_worker, &sw) != 0)
+      break;
+  }
+
+  /* No thread. run here */
+  if (i == 0)
+    sweep_worker(&sw);
+
+  for (j = 0; j < i; j++)
+    pthread_join(tid[j], NULL);
+
+  sweep_report(&sw, nsize, nblock, out);
+
+end:
+  for (j = 0; j < nblock * sw.nseed; j++)
+    free(sample[j]);
+  free(sw.job);
+  return ret;
+}/*}}}*/
+
+#endif
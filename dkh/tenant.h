@@ -0,0 +1,466 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  tenant.h
+ *         @brief:  Tenant (host, disk) key and per tenant cache partition. (run_cache)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 22시 15분 03초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_TENANT_H
+#define __DK_TENANT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+#include "htab.h"
+
+/* Max tenant. later ones share last tenant */
+#define TENANT_MAX 256
+
+/* Quota step of dyn is 1 / TENANT_STEP of equal share */
+#define TENANT_STEP 16
+
+/* Ghost hit gap to move a step. over noise of hit count (sigma) and minimum */
+#define TENANT_SIGMA 3
+#define TENANT_GAP 4
+
+/* Ghost hit loses 1 / 2^TENANT_DECAY every epoch */
+#define TENANT_DECAY 4
+
+/*
+ * Tenant is (host, disk) of request, numbered in order of appearance.
+ *   shared : one cache. line is tenant << TENANT_SHIFT | block, so same
+ *            offset of other volume does not hit.
+ *   static : own cache (same policy) per tenant. quota is c / tenant.
+ *   dyn    : static + every c block access, one step of quota moves from
+ *            tenant of least ghost hit to tenant of most ghost hit, if the
+ *            gap is over TENANT_GAP and TENANT_SIGMA sigma of noise. blocks
+ *            of one request hit together, so variance is sum of square of
+ *            ghost hit per request. tie goes to first tenant from a turn
+ *            that rotates every epoch.
+ *            ghost is LRU of last step lines evicted from partition. ghost
+ *            hit is read miss that one more step would have hit. (marginal
+ *            utility) policy needs resize.
+ * Partition is made by tenant_scan before replay. (every tenant is known)
+ */
+struct tenant_part
+{/*{{{*/
+  long long key;            /* host << 16 | disk */
+  struct cache_mem *cm;     /* partition or NULL (shared) */
+  struct cache_mem *ghost;  /* evicted line LRU (dyn) */
+  long quota;               /* line */
+
+  long read;
+  long hit;
+  long write;
+  long ghost_hit;           /* decayed every epoch (TENANT_DECAY) */
+  long ghost_sq;            /* sum of square of ghost hit per request (noise) */
+  long ghost_total;
+  long grow, shrink;        /* quota step */
+};/*}}}*/
+
+struct tenant
+{/*{{{*/
+  int mode;                 /* TENANT_* */
+  int n;
+  int last;                 /* last tenant. (same tenant in a row) */
+  struct tenant_part *t;    /* TENANT_MAX */
+  struct htab map;          /* host << 16 | disk -> tenant */
+  struct cache_opt opt;     /* partition policy */
+
+  long unit;                /* quota step, ghost size (dyn) */
+  unsigned long long access;  /* block access since last rebalance */
+  unsigned long long epoch;
+  long move;
+  int turn;                 /* first tenant of rebalance scan */
+};/*}}}*/
+
+static char *tenant_name[] = {"off", "shared", "static", "dyn"};
+
+/**
+ * Tenant mode name to number.
+ * @param name : shared, static, dyn
+ * @return : TENANT_* or -1
+ */
+int tenant_mode(char *name)
+{/*{{{*/
+  int i = 0;
+
+  for (i = TENANT_SHARED; i <= TENANT_DYN; i++) {
+    if (strcmp(tenant_name[i], name) == 0)
+      return i;
+  }
+  return -1;
+}/*}}}*/
+
+/**
+ * Free tenant and partition. (del_cm)
+ * @param tn : tenant or NULL
+ */
+void tenant_free(struct tenant *tn)
+{/*{{{*/
+  int i = 0;
+
+  if (!tn)
+    return;
+
+  for (i = 0; i < tn->n; i++) {
+    if (tn->t[i].cm) {
+      /* partition points tenant for evict hook */
+      tn->t[i].cm->tn = NULL;
+      del_cm(tn->t[i].cm);
+    }
+    if (tn->t[i].ghost)
+      del_cm(tn->t[i].ghost);
+  }
+
+  htab_free(&tn->map);
+  free(tn->t);
+  free(tn);
+}/*}}}*/
+
+/**
+ * Init tenant. (set_policy, -x tenant=shared|static|dyn)
+ * @param cm : cache memory
+ * @param opt : option
+ * @return : error code
+ */
+int tenant_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  struct tenant *tn = NULL;
+
+  if (opt->tenant == TENANT_OFF)
+    return 0;
+
+  if (opt->tenant != TENANT_SHARED && (cm->pf || cm->wb)) {
+    printf("[FAIL] tenant partition does not run with ra, write, %s \n", __func__);
+    return -1;
+  }
+  if (opt->tenant == TENANT_DYN && !cache_policy[cm->policy].resize) {
+    printf("[FAIL] tenant dyn needs policy resize (arc, lru), %s \n", __func__);
+    return -1;
+  }
+
+  if (!(tn = calloc(1, sizeof(struct tenant))))
+    return -2;
+  if (!(tn->t = calloc(TENANT_MAX, sizeof(struct tenant_part))) ||
+      htab_init(&tn->map, TENANT_MAX) < 0) {
+    free(tn->t);
+    free(tn);
+    return -2;
+  }
+
+  tn->mode = opt->tenant;
+  tn->last = -1;
+  tn->opt = *opt;
+  tn->epoch = MAX(cm->c, 1);
+  cm->tn = tn;
+  return 0;
+}/*}}}*/
+
+/**
+ * Tenant of request. (new tenant is added)
+ * @param tn : tenant
+ * @param wl : request
+ * @return : tenant number
+ */
+static inline int tenant_id(struct tenant *tn, struct workload *wl)
+{/*{{{*/
+  long long key = (long long)wl->host << 16 | wl->disk_num;
+  unsigned long long *v = NULL;
+
+  if (tn->last >= 0 && tn->t[tn->last].key == key)
+    return tn->last;
+
+  if ((v = htab_get(&tn->map, key))) {
+    tn->last = *v;
+  } else if (tn->n < TENANT_MAX && htab_put(&tn->map, key, tn->n)) {
+    tn->t[tn->n].key = key;
+    tn->last = tn->n++;
+  } else {
+    return TENANT_MAX - 1;
+  }
+
+  return tn->last;
+}/*}}}*/
+
+/**
+ * Evict hook of partition. line goes to ghost of its tenant. (dyn)
+ * @param cm : partition
+ * @param l : line
+ */
+static void tenant_evict(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  LRU_cache(cm->tn->t[l->line >> TENANT_SHIFT].ghost, l->line);
+}/*}}}*/
+
+/**
+ * Make partition of tenant.
+ * @param cm : cache memory
+ * @param i : tenant
+ * @param quota : cache size (line)
+ * @return : error code
+ */
+static int tenant_part_init(struct cache_mem *cm, int i, long quota)
+{/*{{{*/
+  struct tenant *tn = cm->tn;
+  struct tenant_part *p = &tn->t[i];
+  struct cache_policy *cp = &cache_policy[cm->policy];
+
+  /* dyn quota grows. hash is for 2 equal share */
+  if (!(p->cm = init_cache_mem(tn->mode == TENANT_DYN ? 2 * quota : quota)))
+    return -2;
+
+  p->quota = quota;
+  p->cm->c = p->cm->max = quota;
+  p->cm->p = quota >> 1;
+  p->cm->kin = quota >> 2;
+  p->cm->kout = quota >> 1;
+  p->cm->block = cm->block;
+  p->cm->policy = cm->policy;
+  p->cm->key = (long long)i << TENANT_SHIFT;
+  if (cp->init && cp->init(p->cm, &tn->opt) < 0)
+    return -1;
+
+  if (tn->mode == TENANT_DYN) {
+    if (!(p->ghost = init_cache_mem(tn->unit)))
+      return -2;
+    p->ghost->policy = POLICY_LRU;
+    p->cm->tn = tn;
+    p->cm->evict = tenant_evict;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Find every tenant of trace and make partition. (before replay)
+ * @param cm : cache memory
+ * @param rec : records
+ * @param count : number of records
+ * @return : number of tenant or error code
+ */
+int tenant_scan(struct cache_mem *cm, struct trace_rec *rec, unsigned long long count)
+{/*{{{*/
+  struct tenant *tn = cm->tn;
+  struct workload wl;
+  unsigned long long r = 0;
+  long share = 0;
+  int i = 0, ret = 0;
+
+  /* NULL arg */
+  if (!tn || !rec) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  for (r = 0; r < count; r++) {
+    trace_rec_load(&rec[r], &wl);
+    tenant_id(tn, &wl);
+  }
+
+  if (tn->mode == TENANT_SHARED || !tn->n)
+    return tn->n;
+
+  /* Equal share. remainder to first tenants */
+  share = cm->c / tn->n;
+  tn->unit = MAX(share / TENANT_STEP, 1);
+  for (i = 0; i < tn->n; i++) {
+    if ((ret = tenant_part_init(cm, i, share + (i < cm->c % tn->n))) < 0)
+      return ret;
+  }
+
+  return tn->n;
+}/*}}}*/
+
+/**
+ * Ghost hit of request. (dyn, before partition access)
+ * @param cm : partition
+ * @param p : tenant
+ * @param wl : request
+ */
+static void tenant_ghost(struct cache_mem *cm, struct tenant_part *p, struct workload *wl)
+{/*{{{*/
+  long long i = wl->offset / cm->block;
+  long long end = (wl->offset + wl->size) / cm->block;
+  struct cache_line *g = NULL;
+  long n = 0;
+
+  for (; i <= end; i++) {
+    if (cache_policy[cm->policy].lookup(cm, cm->key | i) ||
+        !(g = ARC_lookup(p->ghost, cm->key | i)))
+      continue;
+
+    line_move(p->ghost, g, NULL);
+    if (wl->type == READ)
+      n++;
+  }
+
+  /* Blocks of one request come together. variance is sum of square */
+  p->ghost_hit += n;
+  p->ghost_sq += n * n;
+  p->ghost_total += n;
+}/*}}}*/
+
+/**
+ * Move one step of quota. least ghost hit -> most ghost hit. (dyn)
+ * @param tn : tenant
+ */
+static void tenant_rebalance(struct tenant *tn)
+{/*{{{*/
+  struct tenant_part *r = NULL, *d = NULL, *p = NULL;
+  long gap = 0;
+  int i = 0;
+
+  /* Tie goes to first of scan. start rotates */
+  for (i = 0; i < tn->n; i++) {
+    p = &tn->t[(tn->turn + i) % tn->n];
+    if (!r || p->ghost_hit > r->ghost_hit)
+      r = p;
+    /* donor keeps one step at least */
+    if (p->quota >= 2 * tn->unit && (!d || p->ghost_hit < d->ghost_hit))
+      d = p;
+  }
+  tn->turn = (tn->turn + 1) % tn->n;
+
+  /* Gap of noise is not a move */
+  if (r && d)
+    gap = r->ghost_hit - d->ghost_hit;
+  if (r && d && r != d && gap >= TENANT_GAP &&
+      gap * gap > TENANT_SIGMA * TENANT_SIGMA * (r->ghost_sq + d->ghost_sq)) {
+    d->quota -= tn->unit;
+    r->quota += tn->unit;
+    cache_policy[d->cm->policy].resize(d->cm, d->quota);
+    cache_policy[r->cm->policy].resize(r->cm, r->quota);
+    d->shrink++;
+    r->grow++;
+    tn->move++;
+  }
+
+  for (i = 0; i < tn->n; i++) {
+    tn->t[i].ghost_hit -= tn->t[i].ghost_hit >> TENANT_DECAY;
+    tn->t[i].ghost_sq -= tn->t[i].ghost_sq >> TENANT_DECAY;
+  }
+  tn->access = 0;
+}/*}}}*/
+
+/**
+ * Replay one request on tenant key or partition. (run_cache)
+ * @param cm : cache memory
+ * @param wl : request
+ * @return : number of hit block or error code
+ */
+static int tenant_run(struct cache_mem *cm, struct workload *wl)
+{/*{{{*/
+  struct tenant *tn = cm->tn;
+  struct tenant_part *p = &tn->t[tenant_id(tn, wl)];
+  struct cache_mem *c = p->cm ? p->cm : cm;
+  long read = c->read, hit = c->hit, write = c->write;
+  int n = 0;
+
+  if (tn->mode == TENANT_SHARED) {
+    cm->key = (long long)(p - tn->t) << TENANT_SHIFT;
+    n = cm->pf || cm->wb ? run_line(cm, wl) : cache_policy[cm->policy].run(cm, wl);
+  } else {
+    /* tenant_scan missed */
+    if (!p->cm)
+      return -1;
+
+    if (p->ghost)
+      tenant_ghost(p->cm, p, wl);
+    n = cache_policy[cm->policy].run(p->cm, wl);
+  }
+
+  read = c->read - read;
+  hit = c->hit - hit;
+  write = c->write - write;
+  p->read += read;
+  p->hit += hit;
+  p->write += write;
+  if (c != cm) {
+    cm->read += read;
+    cm->hit += hit;
+    cm->write += write;
+  }
+
+  if (tn->mode == TENANT_DYN && (tn->access += read + write) >= tn->epoch)
+    tenant_rebalance(tn);
+  return n;
+}/*}}}*/
+
+/**
+ * Count resident line per tenant. (hash walk)
+ * @param cm : cache memory or partition
+ * @param count : line per tenant (TENANT_MAX)
+ * @return : error code. (engine without cache_line)
+ */
+static int tenant_resident(struct cache_mem *cm, long *count)
+{/*{{{*/
+  struct list_head *tmp = NULL;
+  struct cache_line *l = NULL;
+  long long i = 0;
+
+  if (!cache_policy[cm->policy].lookup || !cm->hash.bucket)
+    return -1;
+
+  for (i = 0; i < cm->hash.size; i++) {
+    list_each(tmp, &cm->hash.bucket[i]) {
+      l = container_of(tmp, struct cache_line, hash);
+      if (cache_policy[cm->policy].lookup(cm, l->line) == l)
+        count[l->line >> TENANT_SHIFT]++;
+    }
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Tenant stats. hit, occupancy, quota.
+ * @param cm : cache memory
+ */
+void tenant_stats(struct cache_mem *cm)
+{/*{{{*/
+  struct tenant *tn = cm->tn;
+  struct tenant_part *p = NULL;
+  long *count = NULL;
+  int i = 0, ret = 0;
+
+  if (!(count = calloc(TENANT_MAX, sizeof(long))))
+    return;
+
+  if (tn->mode == TENANT_SHARED)
+    ret = tenant_resident(cm, count);
+  for (i = 0; i < tn->n && tn->mode != TENANT_SHARED; i++)
+    ret |= tenant_resident(tn->t[i].cm, count);
+
+  printf("===== Tenant =====\n");
+  printf("mode %s, tenant %d", tenant_name[tn->mode], tn->n);
+  if (tn->mode == TENANT_DYN)
+    printf(", step %ld line, epoch %llu block, move %ld", tn->unit, tn->epoch, tn->move);
+  printf("\n");
+
+  printf("%6s %5s %5s %10s %10s %8s %10s %10s %8s %10s %10s %6s %6s\n", "tenant", "host",
+      "disk", "read", "hit", "ratio", "write", "resident", "occ(%)", "quota", "ghost_hit",
+      "grow", "shrink");
+  for (i = 0; i < tn->n; i++) {
+    p = &tn->t[i];
+    printf("%6d %5lld %5lld %10ld %10ld %8.3f %10ld %10ld %8.3f %10ld %10ld %6ld %6ld\n", i,
+        p->key >> 16, p->key & 0xffff, p->read, p->hit,
+        p->read ? 100.0 * p->hit / p->read : 0, p->write, ret < 0 ? -1 : count[i],
+        ret < 0 || !cm->c ? 0 : 100.0 * count[i] / cm->c,
+        p->cm ? p->quota : cm->c, p->ghost_total, p->grow, p->shrink);
+  }
+
+  free(count);
+}/*}}}*/
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  tinylfu.h
+ *         @brief:  TinyLFU admission. (4 bit count-min sketch + doorkeeper bloom)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 19시 06분 13초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_TINYLFU_H
+#define __DK_TINYLFU_H
+
+#include <stdlib.h>
+#include <string.h>
+#include "hash.h"
+
+/* Sketch rows */
+#define TLFU_DEPTH 4
+
+/* Aging. halve counters every TLFU_SAMPLE * c access */
+#define TLFU_SAMPLE 10
+
+/* Doorkeeper bits per sketch counter */
+#define TLFU_DOOR_BITS 2
+
+/*
+ * First access of key only sets doorkeeper bits. Later access counts in
+ * sketch. (one hit wonder never reaches sketch)
+ * Estimate is min of sketch rows + doorkeeper.
+ */
+struct tinylfu
+{/*{{{*/
+  unsigned long long *sketch;   /* 16 counter per word, TLFU_DEPTH rows */
+  unsigned long long width;     /* counter per row, 2^n */
+  unsigned long long *door;     /* bloom bits */
+  unsigned long long door_mask; /* bit number mask */
+
+  unsigned long long add;       /* access since last aging */
+  unsigned long long sample;
+
+  unsigned long long candidate; /* admission asked */
+  unsigned long long admit;     /* admission granted */
+  unsigned long long reset;     /* aging count */
+};/*}}}*/
+
+/**
+ * Free filter.
+ * @param t : filter
+ */
+static void tlfu_free(struct tinylfu *t)
+{/*{{{*/
+  if (!t)
+    return;
+
+  free(t->sketch);
+  free(t->door);
+  free(t);
+}/*}}}*/
+
+/**
+ * Init filter.
+ * @param c : cache size (line)
+ * @return : filter or NULL
+ */
+static struct tinylfu *tlfu_init(long c)
+{/*{{{*/
+  struct tinylfu *t = NULL;
+
+  if (!(t = calloc(1, sizeof(struct tinylfu))))
+    return NULL;
+
+  t->width = MAX(1ULL << hash_bits(MAX(c, 16)), 16);
+  t->door_mask = t->width * TLFU_DOOR_BITS - 1;
+  t->sample = (unsigned long long)TLFU_SAMPLE * MAX(c, 1);
+
+  t->sketch = calloc(TLFU_DEPTH * t->width / 16, sizeof(unsigned long long));
+  t->door = calloc((t->door_mask + 1) / 64 + 1, sizeof(unsigned long long));
+  if (!t->sketch || !t->door) {
+    tlfu_free(t);
+    return NULL;
+  }
+
+  return t;
+}/*}}}*/
+
+/**
+ * Memory of filter.
+ * @param t : filter
+ * @return : byte
+ */
+static unsigned long long tlfu_bytes(struct tinylfu *t)
+{/*{{{*/
+  return sizeof(struct tinylfu) + TLFU_DEPTH * t->width / 2 +
+    ((t->door_mask + 1) / 64 + 1) * sizeof(unsigned long long);
+}/*}}}*/
+
+/**
+ * Counter index of key in row.
+ * @param t : filter
+ * @param h : mix_64 of key
+ * @param row : row
+ * @return : counter index (whole sketch)
+ */
+static inline unsigned long long tlfu_index(struct tinylfu *t, unsigned long long h, int row)
+{/*{{{*/
+  return row * t->width + ((h + row * ((h >> 32) | 1)) & (t->width - 1));
+}/*}}}*/
+
+/**
+ * Doorkeeper test and set.
+ * @param t : filter
+ * @param h : mix_64 of key
+ * @param set : set bits
+ * @return : 1 (all bits were set)
+ */
+static inline int tlfu_door(struct tinylfu *t, unsigned long long h, int set)
+{/*{{{*/
+  unsigned long long b1 = h & t->door_mask;
+  unsigned long long b2 = (h >> 32) & t->door_mask;
+  int in = (t->door[b1 >> 6] >> (b1 & 63) & 1) && (t->door[b2 >> 6] >> (b2 & 63) & 1);
+
+  if (set) {
+    t->door[b1 >> 6] |= 1ULL << (b1 & 63);
+    t->door[b2 >> 6] |= 1ULL << (b2 & 63);
+  }
+  return in;
+}/*}}}*/
+
+/**
+ * Aging. halve every counter, clear doorkeeper.
+ * @param t : filter
+ */
+static void tlfu_age(struct tinylfu *t)
+{/*{{{*/
+  unsigned long long i = 0;
+
+  for (i = 0; i < TLFU_DEPTH * t->width / 16; i++)
+    t->sketch[i] = (t->sketch[i] >> 1) & 0x7777777777777777ULL;
+  memset(t->door, 0, ((t->door_mask + 1) / 64 + 1) * sizeof(unsigned long long));
+
+  t->add = 0;
+  t->reset++;
+}/*}}}*/
+
+/**
+ * Record access of key.
+ * @param t : filter
+ * @param key : line
+ */
+static inline void tlfu_add(struct tinylfu *t, unsigned long long key)
+{/*{{{*/
+  unsigned long long h = mix_64(key);
+  unsigned long long idx = 0;
+  unsigned long long *w = NULL;
+  int row = 0, shift = 0;
+
+  if (++t->add >= t->sample)
+    tlfu_age(t);
+
+  if (!tlfu_door(t, h, 1))
+    return;
+
+  /* 4 bit saturating counter */
+  for (row = 0; row < TLFU_DEPTH; row++) {
+    idx = tlfu_index(t, h, row);
+    w = &t->sketch[idx >> 4];
+    shift = (idx & 15) << 2;
+    if (((*w >> shift) & 0xf) != 0xf)
+      *w += 1ULL << shift;
+  }
+}/*}}}*/
+
+/**
+ * Estimated frequency of key.
+ * @param t : filter
+ * @param key : line
+ * @return : frequency (0 ~ 16)
+ */
+static inline int tlfu_estimate(struct tinylfu *t, unsigned long long key)
+{/*{{{*/
+  unsigned long long h = mix_64(key);
+  unsigned long long idx = 0;
+  int row = 0, f = 0, min = 0xf;
+
+  for (row = 0; row < TLFU_DEPTH; row++) {
+    idx = tlfu_index(t, h, row);
+    f = (t->sketch[idx >> 4] >> ((idx & 15) << 2)) & 0xf;
+    min = MIN(min, f);
+  }
+
+  return min + tlfu_door(t, h, 0);
+}/*}}}*/
+
+/**
+ * Admission. candidate must be more frequent than victim.
+ * @param t : filter
+ * @param key : candidate line
+ * @param victim : line to be evicted
+ * @return : 1 (admit), 0 (reject)
+ */
+static inline int tlfu_admit(struct tinylfu *t, unsigned long long key, unsigned long long victim)
+{/*{{{*/
+  t->candidate++;
+  if (tlfu_estimate(t, key) > tlfu_estimate(t, victim)) {
+    t->admit++;
+    return 1;
+  }
+  return 0;
+}/*}}}*/
+
+#endif
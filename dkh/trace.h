@@ -0,0 +1,508 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  trace.h
+ *         @brief:  Workload trace reader. (MSR csv, binary trace)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 10시 02분 11초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_TRACE_H
+#define __DK_TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* READ WRITE FLAGS */
+#define READ  1
+#define WRITE 2
+
+/* CSV line buffer */
+#define TRACE_LINE_LEN 256
+
+/* Timestamp tick per second. (100ns windows filetime of MSR Cambridge) */
+#define TRACE_TICK_SEC 10000000ULL
+
+/* Binary trace. header + fixed width records */
+#define TRACE_MAGIC "DKTRACE1"
+#define TRACE_VERSION 1
+#define TRACE_MAX_HOST 64
+#define TRACE_HOST_LEN 16
+
+/* Optional column flags (trace_hdr.flags) */
+#define TRACE_F_TIME (1 << 0)
+#define TRACE_F_HOST (1 << 1)
+#define TRACE_F_DISK (1 << 2)
+#define TRACE_F_RESP (1 << 3)
+
+struct workload
+{/*{{{*/
+  unsigned long long time;
+  int host;
+  int disk_num;
+  int type;
+  long long offset;
+  long size;
+  long respone; //respones time
+
+};/*}}}*/
+
+/* Binary trace header. (1056 byte, multiple of record size) */
+struct trace_hdr
+{/*{{{*/
+  char magic[8];
+  unsigned int version;
+  unsigned int rec_size;
+  unsigned long long count;
+  unsigned int flags;
+  unsigned int nhost;
+  char host[TRACE_MAX_HOST][TRACE_HOST_LEN];
+};/*}}}*/
+
+/* Binary trace record. (32 byte) */
+struct trace_rec
+{/*{{{*/
+  unsigned long long time;
+  unsigned long long offset;
+  unsigned int size;
+  unsigned int respone;
+  unsigned short disk_num;
+  unsigned short host;
+  unsigned char type;
+  unsigned char pad[3];
+};/*}}}*/
+
+struct trace
+{/*{{{*/
+  /* csv */
+  FILE *fp;
+  char buf[TRACE_LINE_LEN];
+
+  /* binary (mmap) or loaded csv */
+  int fd;
+  char *map;
+  size_t map_len;
+  struct trace_hdr *hdr;
+  struct trace_rec *rec;
+  unsigned long long count;
+  unsigned long long pos;
+  int own;                  /* rec is malloc'ed (csv) */
+
+  /* host name table */
+  int nhost;
+  char host[TRACE_MAX_HOST][TRACE_HOST_LEN];
+};/*}}}*/
+
+FILE *open_workload(char *file);
+int host_id(struct trace *t, char *name);
+int read_column(struct trace *t, struct workload *wl, char *buf);
+struct trace *open_trace(char *file);
+static inline void trace_rec_load(struct trace_rec *r, struct workload *wl);
+static inline void trace_rec_save(struct workload *wl, struct trace_rec *r);
+int trace_next(struct trace *t, struct workload *wl);
+struct trace_rec *trace_records(struct trace *t, unsigned long long *count);
+void trace_rewind(struct trace *t);
+void close_trace(struct trace *t);
+long long convert_trace(char *csv, char *bin);
+
+/**
+ * Just open file and return.
+ * @param file : target file path
+ * @return : file pointer
+ */
+FILE *open_workload(char *file)
+{/*{{{*/
+  FILE *fp = NULL;
+
+  /* NULL arg */
+  if (!file) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return NULL;
+  }
+
+  /* open FILE */
+  if (!(fp = fopen(file, "r")))
+    return NULL;
+
+  return fp;
+}/*}}}*/
+
+/**
+ * Host name to host number. (add new name to table)
+ * Table is fixed size of binary header. new host of full table fails.
+ * @param t : trace
+ * @param name : host name
+ * @return : host number or -1 (table full)
+ */
+int host_id(struct trace *t, char *name)
+{/*{{{*/
+  int i = 0;
+
+  for (i = 0; i < t->nhost; i++) {
+    if (strncmp(t->host[i], name, TRACE_HOST_LEN - 1) == 0)
+      return i;
+  }
+
+  if (t->nhost == TRACE_MAX_HOST) {
+    printf("[FAIL] over %d host (%s), %s \n", TRACE_MAX_HOST, name, __func__);
+    return -1;
+  }
+
+  strncpy(t->host[t->nhost], name, TRACE_HOST_LEN - 1);
+  t->host[t->nhost][TRACE_HOST_LEN - 1] = '\0';
+  return t->nhost++;
+}/*}}}*/
+
+/**
+ * read colum. (=Inscribe workload struct)
+ * @param t : trace (host name table)
+ * @param wl : workload struct
+ * @param buf : buffer string
+ * @return : 0, -2 (short line), -3 (host table full), else error code
+ */
+int read_column(struct trace *t, struct workload *wl, char *buf)
+{/*{{{*/
+  int column = 1;
+  char *tmp = NULL;
+  char *save = NULL;
+
+  /* NULL arg */
+  if (!t || !wl || !buf) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  /* read file and, save workload struct */
+  memset(wl, 0, sizeof(struct workload));
+  tmp = strtok_r(buf, ",", &save);
+  while (tmp != NULL) {
+
+    switch (column) {
+      case 1 : wl->time = strtoull(tmp, NULL, 10); break;
+      case 2 :
+        if ((wl->host = host_id(t, tmp)) < 0)
+          return -3;
+        break;
+      case 3 : wl->disk_num = atoi(tmp); break;
+      case 4 : (wl->type) = (strcmp(tmp, "Read") == 0) ? READ : WRITE; break;
+      case 5 : wl->offset = atoll(tmp); break;
+      case 6 : wl->size = atol(tmp); break;
+      case 7 : wl->respone = atol(tmp); break;
+    }
+
+    /* Next */
+    tmp = strtok_r(NULL, ",", &save);
+    column++;
+  }
+
+  /* Short line. (7 column) */
+  if (column <= 7)
+    return -2;
+
+  return 0;
+}/*}}}*/
+
+/**
+ * Open trace file. Binary trace is mapped, else read as csv.
+ * @param file : trace file path
+ * @return : trace struct or NULL
+ */
+struct trace *open_trace(char *file)
+{/*{{{*/
+  struct trace *t = NULL;
+  struct stat st;
+  char magic[8] = {'\0', };
+
+  /* NULL arg */
+  if (!file) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return NULL;
+  }
+
+  if (!(t = calloc(1, sizeof(struct trace))))
+    return NULL;
+
+  t->fd = open(file, O_RDONLY);
+  if (t->fd < 0)
+    goto fail;
+
+  /* Binary trace? */
+  if (read(t->fd, magic, sizeof(magic)) == sizeof(magic) &&
+      memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0) {
+
+    if (fstat(t->fd, &st) < 0 || st.st_size < (off_t)sizeof(struct trace_hdr))
+      goto fail;
+
+    t->map_len = st.st_size;
+    t->map = mmap(NULL, t->map_len, PROT_READ, MAP_SHARED, t->fd, 0);
+    if (t->map == MAP_FAILED)
+      goto fail;
+
+    madvise(t->map, t->map_len, MADV_SEQUENTIAL);
+
+    t->hdr = (struct trace_hdr *)t->map;
+    if (t->hdr->version != TRACE_VERSION ||
+        t->hdr->rec_size != sizeof(struct trace_rec)) {
+      printf("[FAIL] bad trace version, %s \n", file);
+      goto fail;
+    }
+
+    t->rec = (struct trace_rec *)(t->map + sizeof(struct trace_hdr));
+    t->count = (t->map_len - sizeof(struct trace_hdr)) / sizeof(struct trace_rec);
+    if (t->hdr->count < t->count)
+      t->count = t->hdr->count;
+
+    t->nhost = t->hdr->nhost;
+    if (t->nhost > TRACE_MAX_HOST)
+      t->nhost = TRACE_MAX_HOST;
+    memcpy(t->host, t->hdr->host, sizeof(t->host));
+    return t;
+  }
+
+  /* CSV trace */
+  close(t->fd);
+  t->fd = -1;
+  if (!(t->fp = open_workload(file)))
+    goto fail;
+
+  return t;
+
+fail:
+  close_trace(t);
+  return NULL;
+}/*}}}*/
+
+/**
+ * Record to workload.
+ * @param r : binary record
+ * @param wl : workload struct
+ */
+static inline void trace_rec_load(struct trace_rec *r, struct workload *wl)
+{/*{{{*/
+  wl->time = r->time;
+  wl->host = r->host;
+  wl->disk_num = r->disk_num;
+  wl->type = r->type;
+  wl->offset = r->offset;
+  wl->size = r->size;
+  wl->respone = r->respone;
+}/*}}}*/
+
+/**
+ * Workload to record.
+ * @param wl : workload struct
+ * @param r : binary record
+ */
+static inline void trace_rec_save(struct workload *wl, struct trace_rec *r)
+{/*{{{*/
+  memset(r, 0, sizeof(struct trace_rec));
+  r->time = wl->time;
+  r->offset = wl->offset;
+  r->size = wl->size;
+  r->respone = wl->respone;
+  r->disk_num = wl->disk_num;
+  r->host = wl->host;
+  r->type = wl->type;
+}/*}}}*/
+
+/**
+ * Read next request.
+ * @param t : trace
+ * @param wl : workload struct
+ * @return : 1 (read), 0 (end), else error code
+ */
+int trace_next(struct trace *t, struct workload *wl)
+{/*{{{*/
+  char *nl = NULL;
+  int ret = 0;
+
+  /* Binary or loaded */
+  if (t->rec) {
+    if (t->pos >= t->count)
+      return 0;
+
+    trace_rec_load(&t->rec[t->pos++], wl);
+    return 1;
+  }
+
+  /* CSV. skip blank and short line */
+  while (fgets(t->buf, sizeof(t->buf), t->fp)) {
+    if ((nl = strpbrk(t->buf, "\r\n")))
+      *nl = '\0';
+
+    if ((ret = read_column(t, wl, t->buf)) == 0)
+      return 1;
+    if (ret != -2)
+      return ret;
+  }
+
+  return 0;
+}/*}}}*/
+
+/**
+ * All records of trace. csv trace is parsed once and kept in memory.
+ * Records are shared by readers. (do not modify)
+ * @param t : trace
+ * @param count : saved number of records
+ * @return : record array or NULL
+ */
+struct trace_rec *trace_records(struct trace *t, unsigned long long *count)
+{/*{{{*/
+  struct trace_rec *rec = NULL;
+  struct trace_rec *tmp = NULL;
+  struct workload wl;
+  unsigned long long n = 0, cap = 1 << 16;
+  int ret = 0;
+
+  if (t->rec) {
+    *count = t->count;
+    return t->rec;
+  }
+
+  if (!(rec = malloc(cap * sizeof(struct trace_rec))))
+    return NULL;
+
+  rewind(t->fp);
+  while ((ret = trace_next(t, &wl)) == 1) {
+    if (n == cap) {
+      if (!(tmp = realloc(rec, cap * 2 * sizeof(struct trace_rec)))) {
+        free(rec);
+        return NULL;
+      }
+      rec = tmp;
+      cap *= 2;
+    }
+    trace_rec_save(&wl, &rec[n++]);
+  }
+
+  if (ret < 0) {
+    free(rec);
+    return NULL;
+  }
+
+  t->rec = rec;
+  t->count = n;
+  t->pos = 0;
+  t->own = 1;
+
+  *count = n;
+  return rec;
+}/*}}}*/
+
+/**
+ * Go back to first request.
+ * @param t : trace
+ */
+void trace_rewind(struct trace *t)
+{/*{{{*/
+  if (t->rec)
+    t->pos = 0;
+  else
+    rewind(t->fp);
+}/*}}}*/
+
+/**
+ * Close trace. (unmap or close file)
+ * @param t : trace
+ */
+void close_trace(struct trace *t)
+{/*{{{*/
+  if (!t)
+    return;
+
+  if (t->map && t->map != MAP_FAILED)
+    munmap(t->map, t->map_len);
+  if (t->own)
+    free(t->rec);
+  if (t->fd >= 0)
+    close(t->fd);
+  if (t->fp)
+    fclose(t->fp);
+
+  free(t);
+}/*}}}*/
+
+/**
+ * Convert csv trace to binary trace.
+ * @param csv : csv trace path
+ * @param bin : output binary trace path
+ * @return : number of records or error code
+ */
+long long convert_trace(char *csv, char *bin)
+{/*{{{*/
+  struct trace *t = NULL;
+  struct trace_hdr hdr;
+  struct trace_rec r;
+  struct workload wl;
+  FILE *out = NULL;
+  long long n = 0;
+  int ret = 0;
+
+  /* NULL arg */
+  if (!csv || !bin) {
+    printf("[FAIL] arg NULL, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(t = open_trace(csv)))
+    return -2;
+
+  /* Already binary */
+  if (t->map) {
+    printf("[FAIL] not csv trace, %s \n", csv);
+    close_trace(t);
+    return -3;
+  }
+
+  if (!(out = fopen(bin, "w"))) {
+    close_trace(t);
+    return -4;
+  }
+
+  /* Header is written again when count is known */
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, TRACE_MAGIC, sizeof(hdr.magic));
+  hdr.version = TRACE_VERSION;
+  hdr.rec_size = sizeof(struct trace_rec);
+  hdr.flags = TRACE_F_TIME | TRACE_F_HOST | TRACE_F_DISK | TRACE_F_RESP;
+  if (fwrite(&hdr, sizeof(hdr), 1, out) != 1)
+    ret = -5;
+
+  while (!ret && (ret = trace_next(t, &wl)) == 1) {
+    trace_rec_save(&wl, &r);
+    ret = fwrite(&r, sizeof(r), 1, out) == 1 ? 0 : -5;
+    n++;
+  }
+
+  hdr.count = n;
+  hdr.nhost = t->nhost;
+  memcpy(hdr.host, t->host, sizeof(hdr.host));
+
+  /* Header of count. truncated file must not look complete */
+  rewind(out);
+  if (!ret && fwrite(&hdr, sizeof(hdr), 1, out) != 1)
+    ret = -5;
+  if (fclose(out) != 0 && !ret)
+    ret = -5;
+  close_trace(t);
+
+  if (ret < 0) {
+    printf("[FAIL] convert (%d), %s \n", ret, bin);
+    return ret;
+  }
+  return n;
+}/*}}}*/
+
+#endif
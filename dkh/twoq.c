@@ -0,0 +1,87 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  twoq.c
+ *         @brief:  2Q. (Johnson & Shasha, VLDB 94, full version)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 17시 31분 52초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+/*
+ * 2Q uses cache_mem of ARC.
+ *   A1in = mru : FIFO of first access. hit does not move line.
+ *   A1out = mrug : ghost FIFO of line paged out from A1in.
+ *   Am = mfu : LRU of line hit in A1out.
+ * Kin (cm->kin) is max A1in, Kout (cm->kout) is max A1out.
+ * A scan passes through A1in and A1out, and never reaches Am.
+ */
+
+struct cache_line *TWOQ_cache(struct cache_mem *cm, long long line);
+
+/**
+ * Make room for one line. (cache is full)
+ * A1in over Kin gives its oldest line to A1out, else LRU of Am is dropped.
+ * @param cm : cache memory.
+ */
+static inline void TWOQ_reclaim(struct cache_mem *cm)
+{/*{{{*/
+  if (cm->mru.size + cm->mfu.size < cm->c)
+    return;
+
+  if (cm->mru.size > cm->kin || cm->mfu.size == 0) {
+    line_move(cm, ARC_state_lru(&cm->mru), &cm->mrug);
+    if (cm->mrug.size > cm->kout)
+      line_move(cm, ARC_state_lru(&cm->mrug), NULL);
+  } else {
+    line_move(cm, ARC_state_lru(&cm->mfu), NULL);
+  }
+}/*}}}*/
+
+/**
+ * 2Q Main function.
+ * @param cm : cache memory.
+ * @param line : line
+ * @return : line (hit in A1in, Am) or NULL (miss, A1out hit)
+ */
+struct cache_line *TWOQ_cache(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct cache_line *l = ARC_lookup(cm, line);
+
+  if (l) {
+    /* Am hit. move to MRU */
+    if (l->state == &cm->mfu) {
+      list_move(&l->head, &cm->mfu.head);
+      return l;
+    }
+
+    /* A1in hit. stay in FIFO (correlated reference) */
+    if (l->state == &cm->mru)
+      return l;
+
+    /* A1out hit. second reference, goes to Am */
+    line_unlink(l);
+    TWOQ_reclaim(cm);
+    line_move(cm, l, &cm->mfu);
+    cm->b1_hit++;
+    return NULL;
+  }
+
+  if (cm->c <= 0)
+    return NULL;
+
+  TWOQ_reclaim(cm);
+
+  if (!(l = create_line(cm, line)))
+    return NULL;
+
+  hash_insert(cm, l);
+  line_move(cm, l, &cm->mru);
+  return NULL;
+}/*}}}*/
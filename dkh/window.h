@@ -0,0 +1,260 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  window.h
+ *         @brief:  Windowed statistics stream of sim. (csv, every N request or T sec)
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 22시 52분 36초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_WINDOW_H
+#define __DK_WINDOW_H
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "trace.h"
+
+/*
+ * One csv record per window. window ends every step request, or when
+ * trace time passes span tick. (whichever first, 0 is off)
+ * Record is written before first request of next window, so window
+ * counter is exact. Last window is written by win_end.
+ *   time    : trace time of last request of window (sec from first request)
+ *   ratio   : read hit ratio of window, and so far (cum_hit_ratio)
+ *   p ~ b2  : list size at end of window (gnu/result_p)
+ * Partition (tenant static, dyn) has no list in cm. p ~ b2, ghost hit,
+ * evict and resident are sum of every partition.
+ *   evict   : resident line dropped in window
+ *   req/sec : simulator speed of window (wall clock)
+ */
+struct window
+{/*{{{*/
+  FILE *fp;
+  long step;                    /* request. 0 is off */
+  unsigned long long span;      /* trace tick. 0 is off */
+
+  unsigned long long req;       /* request so far */
+  unsigned long long last;      /* request at last record */
+  unsigned long long start;     /* trace time of first request */
+  unsigned long long next;      /* trace time of next window */
+  unsigned long long now;       /* trace time of last request */
+  struct timespec wall;         /* wall clock of window start */
+
+  /* cache_mem counter at window start */
+  long read, write, hit;
+  long b1_hit, b2_hit;
+  long evicted;
+  struct req_stat rreq;
+};/*}}}*/
+
+/* List state of cache. (partition is summed) */
+struct win_list
+{/*{{{*/
+  long p, t1, t2, b1, b2;
+  long b1_hit, b2_hit;
+};/*}}}*/
+
+/**
+ * Resident line of one cache.
+ * @param cm : cache memory or partition
+ * @return : line
+ */
+static long win_lines(struct cache_mem *cm)
+{/*{{{*/
+  struct fifo *f = cm->priv;
+
+  switch (cm->policy) {
+    case POLICY_LIRS : return cm->lir + cm->mfu.size;
+    case POLICY_S3FIFO : return f->s.head - f->s.tail + f->m.head - f->m.tail;
+    case POLICY_SIEVE : return f->live;
+  }
+  return cm->mru.size + cm->mfu.size;
+}/*}}}*/
+
+/**
+ * Evicted line of one cache.
+ * @param cm : cache memory or partition
+ * @return : line
+ */
+static long win_drop(struct cache_mem *cm)
+{/*{{{*/
+  return cm->evicted + (cm->priv ? ((struct fifo *)cm->priv)->evict : 0);
+}/*}}}*/
+
+/**
+ * Resident or evicted line of cache. (partition is summed)
+ * @param cm : cache memory
+ * @param fn : win_lines, win_drop
+ * @return : line
+ */
+static long win_sum(struct cache_mem *cm, long (*fn)(struct cache_mem *cm))
+{/*{{{*/
+  long n = 0;
+  int i = 0;
+
+  if (!cm->tn || cm->tn->mode == TENANT_SHARED)
+    return fn(cm);
+
+  for (i = 0; i < cm->tn->n; i++)
+    n += cm->tn->t[i].cm ? fn(cm->tn->t[i].cm) : 0;
+  return n;
+}/*}}}*/
+
+/**
+ * Add list state of one cache.
+ * @param cm : cache memory or partition
+ * @param s : list state
+ */
+static void win_list_add(struct cache_mem *cm, struct win_list *s)
+{/*{{{*/
+  s->p += cm->p;
+  s->t1 += cm->mru.size;
+  s->t2 += cm->mfu.size;
+  s->b1 += cm->mrug.size;
+  s->b2 += cm->mfug.size;
+  s->b1_hit += cm->b1_hit;
+  s->b2_hit += cm->b2_hit;
+}/*}}}*/
+
+/**
+ * List state of cache. (partition is summed)
+ * @param cm : cache memory
+ * @param s : saved list state
+ */
+static void win_list(struct cache_mem *cm, struct win_list *s)
+{/*{{{*/
+  int i = 0;
+
+  memset(s, 0, sizeof(struct win_list));
+  if (!cm->tn || cm->tn->mode == TENANT_SHARED) {
+    win_list_add(cm, s);
+    return;
+  }
+
+  for (i = 0; i < cm->tn->n; i++) {
+    if (cm->tn->t[i].cm)
+      win_list_add(cm->tn->t[i].cm, s);
+  }
+}/*}}}*/
+
+/**
+ * Save counter of window start.
+ * @param w : window
+ * @param cm : cache memory
+ */
+static void win_mark(struct window *w, struct cache_mem *cm)
+{/*{{{*/
+  struct win_list s;
+
+  win_list(cm, &s);
+  w->read = cm->read;
+  w->write = cm->write;
+  w->hit = cm->hit;
+  w->b1_hit = s.b1_hit;
+  w->b2_hit = s.b2_hit;
+  w->evicted = win_sum(cm, win_drop);
+  w->rreq = cm->rreq;
+  w->last = w->req;
+  clock_gettime(CLOCK_MONOTONIC, &w->wall);
+}/*}}}*/
+
+/**
+ * Init window and write csv header.
+ * @param w : window
+ * @param cm : cache memory
+ * @param fp : output
+ * @param step : window request (0 is off)
+ * @param span : window trace tick (0 is off)
+ */
+void win_init(struct window *w, struct cache_mem *cm, FILE *fp, long step,
+    unsigned long long span)
+{/*{{{*/
+  memset(w, 0, sizeof(struct window));
+  w->fp = fp;
+  w->step = step;
+  w->span = span;
+  win_mark(w, cm);
+
+  fprintf(fp, "req,time,read,write,hit_ratio,cum_hit_ratio,read_full,byte_hit,"
+      "p,t1,t2,b1,b2,b1_hit,b2_hit,evict,resident,req_per_sec\n");
+}/*}}}*/
+
+/**
+ * Write record of window, start next window.
+ * @param w : window
+ * @param cm : cache memory
+ */
+static void win_write(struct window *w, struct cache_mem *cm)
+{/*{{{*/
+  struct timespec now;
+  struct win_list s;
+  long read = cm->read - w->read;
+  long rreq = cm->rreq.req - w->rreq.req;
+  unsigned long long byte = cm->rreq.byte - w->rreq.byte;
+  double sec = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  sec = (now.tv_sec - w->wall.tv_sec) + (now.tv_nsec - w->wall.tv_nsec) / 1e9;
+  win_list(cm, &s);
+
+  fprintf(w->fp, "%llu,%.3f,%ld,%ld,%.3f,%.3f,%.3f,%.3f", w->req,
+      (double)(w->now - w->start) / TRACE_TICK_SEC, read, cm->write - w->write,
+      read ? 100.0 * (cm->hit - w->hit) / read : 0,
+      cm->read ? 100.0 * cm->hit / cm->read : 0,
+      rreq ? 100.0 * (cm->rreq.full - w->rreq.full) / rreq : 0,
+      byte ? 100.0 * (cm->rreq.hit_byte - w->rreq.hit_byte) / byte : 0);
+  fprintf(w->fp, ",%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%.0f\n", s.p, s.t1, s.t2, s.b1, s.b2,
+      s.b1_hit - w->b1_hit, s.b2_hit - w->b2_hit, win_sum(cm, win_drop) - w->evicted,
+      win_sum(cm, win_lines),
+      sec > 0 ? (w->req - w->last) / sec : 0);
+
+  win_mark(w, cm);
+}/*}}}*/
+
+/**
+ * Request comes. close window if it ends here. (before run_cache)
+ * @param w : window
+ * @param cm : cache memory
+ * @param wl : request
+ */
+static inline void win_add(struct window *w, struct cache_mem *cm, struct workload *wl)
+{/*{{{*/
+  int end = 0;
+
+  if (!w->req) {
+    w->start = wl->time;
+    w->next = wl->time + w->span;
+  } else {
+    end = w->step && w->req % w->step == 0;
+    if (w->span && wl->time >= w->next) {
+      end = 1;
+      w->next += ((wl->time - w->next) / w->span + 1) * w->span;
+    }
+    if (end)
+      win_write(w, cm);
+  }
+
+  w->req++;
+  w->now = wl->time;
+}/*}}}*/
+
+/**
+ * Write last window. (after replay)
+ * @param w : window
+ * @param cm : cache memory
+ */
+void win_end(struct window *w, struct cache_mem *cm)
+{/*{{{*/
+  if (w->req > w->last)
+    win_write(w, cm);
+}/*}}}*/
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * =====================================================================================
+ *
+ *          @file:  writeback.h
+ *         @brief:  Write through / write back. dirty line and backend write accounting.
+ *
+ *        Version:  1.0
+ *          @date:  2026년 10월 18일 21시 07분 52초
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *        @author:  Park jun hyung (), google@dankook.ac.kr
+ *       @COMPANY:  Dankopok univ.
+ * =====================================================================================
+ */
+
+#ifndef __DK_WRITEBACK_H
+#define __DK_WRITEBACK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Write is cached (write allocate) in every mode.
+ *   write through : every written block is a backend write.
+ *   write back    : written line gets LINE_DIRTY. dirty line leaving cache
+ *                   (evict hook) is a backend write. write on dirty line
+ *                   is absorbed. write not cached (admission, c = 0) goes
+ *                   to backend.
+ * Flusher (dirty=ratio) cleans oldest dirty line while dirty > ratio * c.
+ * Dirty queue is a ring of line numbers in dirty order. Dirty line keeps
+ * position of its newest entry (wpos), so entry of line flushed, evicted
+ * or dirtied again later is stale and skipped. full ring is compacted.
+ */
+struct writeback
+{/*{{{*/
+  int mode;                 /* WB_* */
+  long dirty;               /* dirty line */
+  long dirty_max;           /* flusher threshold. 0 is off */
+  struct fifo_ring q;       /* dirty queue. (fifo.c) */
+
+  void (*evict)(struct cache_mem *cm, struct cache_line *l);  /* chained hook */
+
+  long through;             /* write through */
+  long around;              /* write not cached */
+  long evict_write;         /* dirty eviction */
+  long flush;               /* flusher */
+  long absorb;              /* write on dirty line */
+  long compact;             /* dirty queue compaction */
+};/*}}}*/
+
+/**
+ * Write policy name to number.
+ * @param name : wt, wb
+ * @return : WB_* or -1
+ */
+int wb_mode(char *name)
+{/*{{{*/
+  if (strcmp(name, "wt") == 0)
+    return WB_THROUGH;
+  if (strcmp(name, "wb") == 0)
+    return WB_BACK;
+  return -1;
+}/*}}}*/
+
+/**
+ * Free write policy. (del_cm)
+ * @param wb : write policy or NULL
+ */
+void wb_free(struct writeback *wb)
+{/*{{{*/
+  if (!wb)
+    return;
+
+  free(wb->q.slot);
+  free(wb);
+}/*}}}*/
+
+/**
+ * Backend write of all kind.
+ * @param wb : write policy
+ * @return : number of block write
+ */
+static inline long wb_backend(struct writeback *wb)
+{/*{{{*/
+  return wb->through + wb->around + wb->evict_write + wb->flush;
+}/*}}}*/
+
+/**
+ * Evict hook. dirty line is written to backend.
+ * @param cm : cache memory
+ * @param l : line
+ */
+static void wb_evict(struct cache_mem *cm, struct cache_line *l)
+{/*{{{*/
+  if (l->flag & LINE_DIRTY) {
+    l->flag &= ~LINE_DIRTY;
+    cm->wb->dirty--;
+    cm->wb->evict_write++;
+  }
+
+  if (cm->wb->evict)
+    cm->wb->evict(cm, l);
+}/*}}}*/
+
+/**
+ * Init write policy. (set_policy, -x write=wt|wb,dirty=ratio)
+ * @param cm : cache memory
+ * @param opt : option
+ * @return : error code
+ */
+int wb_init(struct cache_mem *cm, struct cache_opt *opt)
+{/*{{{*/
+  struct writeback *wb = NULL;
+
+  if (opt->wmode == WB_NONE)
+    return 0;
+
+  if (!cache_policy[cm->policy].lookup || opt->dirty < 0 || opt->dirty > 1) {
+    printf("[FAIL] write policy needs cache_line policy, dirty is 0 ~ 1, %s \n", __func__);
+    return -1;
+  }
+
+  if (!(wb = calloc(1, sizeof(struct writeback))))
+    return -2;
+
+  wb->mode = opt->wmode;
+  wb->dirty_max = opt->dirty > 0 ? MAX((long)(opt->dirty * cm->c), 1) : 0;
+  if (wb->mode == WB_BACK && fifo_ring_init(&wb->q, 2 * cm->c + 1) < 0) {
+    free(wb);
+    return -2;
+  }
+
+  wb->evict = cm->evict;
+  cm->evict = wb_evict;
+  cm->wb = wb;
+  return 0;
+}/*}}}*/
+
+/**
+ * Dirty line of queue entry.
+ * @param cm : cache memory
+ * @param pos : queue position
+ * @return : line or NULL (stale entry)
+ */
+static inline struct cache_line *wb_entry(struct cache_mem *cm, unsigned long long pos)
+{/*{{{*/
+  struct cache_line *l = cache_policy[cm->policy].lookup(cm, *fifo_at(&cm->wb->q, pos));
+
+  if (!l || !(l->flag & LINE_DIRTY) || l->wpos != (unsigned int)pos)
+    return NULL;
+  return l;
+}/*}}}*/
+
+/**
+ * Drop stale entries of dirty queue. (one entry per dirty line)
+ * @param cm : cache memory
+ */
+static void wb_compact(struct cache_mem *cm)
+{/*{{{*/
+  struct writeback *wb = cm->wb;
+  struct cache_line *l = NULL;
+  unsigned long long r = 0, w = wb->q.tail;
+
+  for (r = wb->q.tail; r < wb->q.head; r++) {
+    if (!(l = wb_entry(cm, r)))
+      continue;
+
+    l->wpos = w;
+    *fifo_at(&wb->q, w++) = *fifo_at(&wb->q, r);
+  }
+
+  wb->q.head = w;
+  wb->compact++;
+}/*}}}*/
+
+/**
+ * Flusher. clean oldest dirty line until dirty <= dirty_max.
+ * @param cm : cache memory
+ */
+static void wb_flush(struct cache_mem *cm)
+{/*{{{*/
+  struct writeback *wb = cm->wb;
+  struct cache_line *l = NULL;
+
+  while (wb->dirty > wb->dirty_max && wb->q.tail < wb->q.head) {
+    if (!(l = wb_entry(cm, wb->q.tail++)))
+      continue;
+
+    l->flag &= ~LINE_DIRTY;
+    wb->dirty--;
+    wb->flush++;
+  }
+}/*}}}*/
+
+/**
+ * Written block. (after policy access)
+ * @param cm : cache memory
+ * @param line : line
+ */
+static inline void wb_write(struct cache_mem *cm, long long line)
+{/*{{{*/
+  struct writeback *wb = cm->wb;
+  struct cache_line *l = NULL;
+
+  if (wb->mode == WB_THROUGH) {
+    wb->through++;
+    return;
+  }
+
+  if (!(l = cache_policy[cm->policy].lookup(cm, line))) {
+    wb->around++;
+    return;
+  }
+
+  if (l->flag & LINE_DIRTY) {
+    wb->absorb++;
+    return;
+  }
+
+  l->flag |= LINE_DIRTY;
+  wb->dirty++;
+
+  if (wb->q.head - wb->q.tail > wb->q.mask)
+    wb_compact(cm);
+  l->wpos = fifo_push(&wb->q, line);
+
+  if (wb->dirty_max && wb->dirty > wb->dirty_max)
+    wb_flush(cm);
+}/*}}}*/
+
+/**
+ * Write policy stats.
+ * @param cm : cache memory
+ */
+void wb_stats(struct cache_mem *cm)
+{/*{{{*/
+  struct writeback *wb = cm->wb;
+
+  printf("===== Write =====\n");
+  printf("mode %s, flusher %ld line\n", wb->mode == WB_BACK ? "write back" : "write through",
+      wb->dirty_max);
+  printf("write %ld, absorbed %ld (%.2f%%), dirty at end %ld\n", cm->write, wb->absorb,
+      cm->write ? 100.0 * wb->absorb / cm->write : 0, wb->dirty);
+  printf("backend write %ld, %llu byte (through %ld, around %ld, evict %ld, flush %ld)\n",
+      wb_backend(wb), (unsigned long long)wb_backend(wb) * cm->block, wb->through,
+      wb->around, wb->evict_write, wb->flush);
+  if (wb->mode == WB_BACK)
+    printf("dirty queue compact %ld\n", wb->compact);
+}/*}}}*/
+
+#endif
@@ -23,5 +23,5 @@ set yrange [0:100]
 set xtic rotate by 0 scale 1
 
 #Print (2 to 3)
-plot for [i=2:3] 'result.dat' using i:xtic(1) title columnheader(i)
+plot for [i=2:3] 'result.dat' index 0 using i:xtic(1) title columnheader(i)
 set output
@@ -0,0 +1,29 @@
+set terminal postscript enhanced mono
+set term post font ",20"
+set output "gnuplot.eps"
+
+#Style
+set style data linespoints
+
+#Title
+set title "Cache hit ratio and optimal (MIN)"
+
+#Key
+set key bottom
+
+#Lable
+set ylabel "Hit rato(%)"
+set xlabel "Cache size(2^n)"
+
+#yrange
+set yrange [0:100]
+
+#Xtic rotate(Not do)
+set xtic rotate by 0 scale 1
+
+#Print (policy curve and upper bound, same -s -b)
+#  ./main -m sweep -p arc,lru,2q -o result.dat trace
+#  ./main -m min -o min.dat trace
+plot for [i=2:*] 'result.dat' index 0 using i:xtic(1) title columnheader(i), \
+     for [i=2:*] 'min.dat' index 0 using i:xtic(1) title columnheader(i) dashtype 2
+set output
@@ -0,0 +1,27 @@
+
+set terminal postscript enhanced mono
+set term post font ",20"
+set output "gnuplot.eps"
+
+#Style
+set style data linespoints
+
+#Title
+set title "LRU cache hit ratio (mrc)"
+
+#Key
+set key bottom
+
+#Lable
+set ylabel "Hit rato(%)"
+set xlabel "Cache size(2^n)"
+
+#yrange
+set yrange [0:100]
+
+#Xtic rotate(Not do)
+set xtic rotate by 0 scale 1
+
+#Print (one column per block size. ./main -m mrc -b 4,8 -o result.dat)
+plot for [i=2:*] 'result.dat' using i:xtic(1) title columnheader(i)
+set output
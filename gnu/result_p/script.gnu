@@ -0,0 +1,25 @@
+set terminal postscript enhanced mono
+set term post font ",20"
+set output "gnuplot.eps"
+
+#Style
+set style data lines
+
+#Title
+set title "ARC adaptation (p trajectory)"
+
+#Key
+set key top right
+
+#Lable
+set ylabel "Line"
+set xlabel "Request"
+
+#csv of window stats
+set datafile separator ","
+
+#Print (./main -o result.dat -i 10000 trace 16)
+plot 'result.dat' using 1:9 title "p", \
+     '' using 1:10 title "T1", \
+     '' using 1:11 title "T2"
+set output
@@ -0,0 +1,34 @@
+set terminal postscript enhanced mono
+set term post font ",20"
+set output "gnuplot.eps"
+
+#Style
+set style data linespoints
+
+#Title
+set title "Reuse distance, inter reference time"
+
+#Key
+set key top right
+
+#Lable
+set ylabel "Reuse(%)"
+set xlabel "Distance, time(block, 2^n bucket)"
+
+#Xtic rotate
+set xtic rotate by -45 scale 1
+
+#Print (rd, irt column per block size. ./main -m reuse -b 4,8 -o result.dat)
+plot for [i=2:*] 'result.dat' index 0 using 0:i:xtic(1) title columnheader(i)
+set output
+
+#Footprint over request (index 1)
+set output "footprint.eps"
+set style data lines
+set title "Footprint"
+set key top left
+set ylabel "Footprint(MB)"
+set xlabel "Request"
+set xtic rotate by 0 scale 1
+plot for [i=3:*] 'result.dat' index 1 using 1:i title columnheader(i)
+set output
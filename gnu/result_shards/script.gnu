@@ -0,0 +1,26 @@
+set terminal postscript enhanced mono
+set term post font ",20"
+set output "gnuplot.eps"
+
+#Style
+set style data yerrorlines
+
+#Title
+set title "LRU cache hit ratio (shards)"
+
+#Key
+set key bottom
+
+#Lable
+set ylabel "Hit rato(%)"
+set xlabel "Cache size(2^n)"
+
+#yrange
+set yrange [0:100]
+
+#Xtic rotate(Not do)
+set xtic rotate by 0 scale 1
+
+#Print (mean, stddev column per block size. ./main -m shards -b 4,8 -o result.dat)
+plot for [i=2:*:2] 'result.dat' using 0:i:i+1:xtic(1) title columnheader(i)
+set output
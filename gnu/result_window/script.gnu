@@ -0,0 +1,28 @@
+set terminal postscript enhanced mono
+set term post font ",20"
+set output "gnuplot.eps"
+
+#Style
+set style data lines
+
+#Title
+set title "Hit ratio over trace time (window)"
+
+#Key
+set key bottom right
+
+#Lable
+set ylabel "Hit rato(%)"
+set xlabel "Trace time(sec)"
+
+#yrange
+set yrange [0:100]
+
+#csv of window stats
+set datafile separator ","
+
+#Print (./main -o result.dat -i 60s trace 16)
+plot 'result.dat' using 2:5 title "window", \
+     '' using 2:6 title "cumulative", \
+     '' using 2:8 title "byte"
+set output
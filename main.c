@@ -19,7 +19,110 @@
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
 #include "./dkh/arc.c"
+#include "./dkh/mrc.h"
+#include "./dkh/hash_bench.h"
+#include "./dkh/sweep.h"
+#include "./dkh/sarc.h"
+#include "./dkh/belady.h"
+#include "./dkh/reuse.h"
+
+/* sim -o : window stats every LOG_STEP request */
+#define LOG_STEP 10000
+
+/**
+ * Print usage.
+ * @param name : program name
+ */
+static void usage(char *name)
+{/*{{{*/
+  int i = 0;
+
+  printf("usage : %s [-m mode] [-p policy,..] [-x key=value,..] [-o output] [-b KB,KB..]"
+      " [-s MB,MB..] [-r rate] [-t thread] <trace> [cache size(MB)]\n", name);
+  printf("  -m sim     : run cache simulator (default, -o window stats csv)\n");
+  printf("  -m convert : convert csv trace to binary trace (-o output)\n");
+  printf("  -m mrc     : LRU hit ratio of 1MB ~ 512MB in one pass (-o result.dat)\n");
+  printf("  -m shards  : sampled LRU hit ratio, mean and stddev of %d seeds (-r, -o result.dat)\n",
+      SHARDS_SEED);
+  printf("  -m hash    : hash function bench on trace block numbers\n");
+  printf("  -m sweep   : run every cache size x block size on threads (-o result.dat)\n");
+  printf("  -m mini    : mini simulation sweep at -r rate, mean and stddev of %d seeds (-o result.dat)\n",
+      SHARDS_SEED);
+  printf("  -m min     : Belady MIN (optimal) of every cache size x block size (-o min.dat)\n");
+  printf("               csv trace is loaded in memory, -m convert to .bin first for large trace\n");
+  printf("  -m reuse   : reuse distance, irt histogram, footprint every -i, one hit wonder (-o result.dat)\n");
+  printf("  -m contend : sharded arc lock contention bench, 1 ~ -t thread (no trace)\n");
+  printf("  -p         : replacement policy for sim, sweep, mini. (%s", cache_policy[0].name);
+  for (i = 1; i < POLICY_NUM; i++)
+    printf(", %s", cache_policy[i].name);
+  printf(")\n");
+  printf("               sweep, mini run every policy of list, sim runs first one\n");
+  printf("  -x         : policy parameter. (ratio of cache size)\n");
+  printf("               p=ratio        : initial p of arc, car, cold target of clockpro\n");
+  printf("               kin=,kout=     : A1in, A1out of 2q (default 0.25, 0.5)\n");
+  printf("               hir=,nr=       : resident, non-resident HIR of lirs (default 0.01, 2)\n");
+  printf("               small=,move=   : S queue, S to M counter of s3fifo (default 0.1, 1)\n");
+  printf("               tlfu=1         : TinyLFU admission in front of arc\n");
+  printf("               ra=,stream=    : readahead block, stream table (default 0 off, 32)\n");
+  printf("               write=wt|wb    : write through, write back (default no backend write)\n");
+  printf("               dirty=ratio    : write back flusher threshold (default 0 off)\n");
+  printf("               lat=n          : read hit latency, miss is trace respone (default off)\n");
+  printf("               tenant=mode    : (host, disk) key shared, partition static or dyn (default off)\n");
+  printf("  -b         : block size list (KB) for mrc, sweep, mini, min, reuse. (default 4)\n");
+  printf("  -s         : cache size list (MB) for sweep, min. (default 1,2,4 .. 512)\n");
+  printf("               mini default is %d size per octave of 1 ~ 512\n", SWEEP_MINI_STEP);
+  printf("  -r         : shards, mini rate (0 ~ 1) or shards sample set size (block). (default %g)\n",
+      SHARDS_RATE);
+  printf("  -t         : number of thread for sweep. (default number of cpu)\n");
+  printf("  -i         : window stats interval for sim. n request or n's' trace second (default %d)\n",
+      LOG_STEP);
+}/*}}}*/
+
+/**
+ * Parse size list. ("4,8,16" KB or MB)
+ * @param str : option string
+ * @param list : saved size (byte)
+ * @param max : list array size
+ * @param unit : KB or MB
+ * @return : number of size
+ */
+static int parse_list(char *str, long *list, int max, long unit)
+{/*{{{*/
+  char *tmp = NULL;
+  char *save = NULL;
+  int n = 0;
+
+  for (tmp = strtok_r(str, ",", &save); tmp && n < max; tmp = strtok_r(NULL, ",", &save)) {
+    if (atol(tmp) > 0)
+      list[n++] = atol(tmp) * unit;
+  }
+
+  return n;
+}/*}}}*/
+
+/**
+ * Parse policy list. ("arc,lru,2q")
+ * @param str : option string
+ * @param list : saved policy (POLICY_*)
+ * @param max : list array size
+ * @return : number of policy or -1 (unknown name)
+ */
+static int parse_policy(char *str, int *list, int max)
+{/*{{{*/
+  char *tmp = NULL;
+  char *save = NULL;
+  int n = 0;
+
+  for (tmp = strtok_r(str, ",", &save); tmp && n < max; tmp = strtok_r(NULL, ",", &save)) {
+    if ((list[n++] = policy_id(tmp)) < 0)
+      return -1;
+  }
+
+  return n;
+}/*}}}*/
 
 /**
  * Main function
@@ -27,23 +130,236 @@
  */
 int main(int argc, char *argv[]){
 
-  FILE *fp;
+  struct trace *t = NULL;
+  char *mode = "sim";
+  char *out = NULL;
+  FILE *fp = NULL;
+  long block[SWEEP_MAX_BLOCK] = {CACHE_BLOCK_SIZE, };
+  long size[SWEEP_MAX_SIZE];
+  int policy[SWEEP_MAX_POLICY];
+  int npolicy = 1;
+  int nblock = 1;
+  int nsize = 0;
+  int nsize_opt = 0;
+  int nthread = 0;
+  struct cache_opt conf;
+  long step = LOG_STEP;
+  unsigned long long span = 0;
+  char *unit = NULL;
+  double rate = SHARDS_RATE;
+  long long n = 0;
+  int opt = 0;
+  int ret = 0;
 
   srandom(time(NULL));
+  init_cache_opt(&conf);
+  policy[0] = conf.policy;
+
+  /* Default sweep size. 1MB ~ 512MB */
+  for (nsize = 0; nsize < 10; nsize++)
+    size[nsize] = (1L << nsize) * MB;
+
+  while ((opt = getopt(argc, argv, "m:p:x:o:b:s:r:t:i:h")) != -1) {
+    switch (opt) {
+      case 'm' : mode = optarg; break;
+      case 'p' :
+        if ((npolicy = parse_policy(optarg, policy, SWEEP_MAX_POLICY)) <= 0) {
+          usage(argv[0]);
+          return -1;
+        }
+        conf.policy = policy[0];
+        break;
+      case 'x' :
+        if (parse_cache_opt(&conf, optarg) < 0) {
+          usage(argv[0]);
+          return -1;
+        }
+        break;
+      case 'o' : out = optarg; break;
+      case 'b' : nblock = parse_list(optarg, block, MIN(MRC_MAX_BLOCK, SWEEP_MAX_BLOCK), KB); break;
+      case 's' :
+        nsize = parse_list(optarg, size, SWEEP_MAX_SIZE, MB);
+        nsize_opt = 1;
+        break;
+      case 'r' : rate = atof(optarg); break;
+      case 't' : nthread = atoi(optarg); break;
+      case 'i' :
+        /* "60s" is trace time */
+        step = MAX(strtol(optarg, &unit, 10), 1);
+        if (*unit == 's') {
+          span = step * TRACE_TICK_SEC;
+          step = 0;
+        }
+        break;
+      default : usage(argv[0]); return -1;
+    }
+  }
+
+  /* Sharded arc contention. (cache size is first arg, default 128MB) */
+  if (strcmp(mode, "contend") == 0) {
+    n = optind < argc ? atol(argv[optind]) * MB : CACHE_SIZE;
+    if (run_sarc_bench(n / CACHE_BLOCK_SIZE, SARC_SHARD,
+          nthread > 0 ? nthread : SARC_BENCH_MAX_THREAD) < 0) {
+      printf("FAIL contend\n");
+      return -1;
+    }
+    return 0;
+  }
+
+  if (optind >= argc) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  /* Convert csv to binary trace */
+  if (strcmp(mode, "convert") == 0) {
+    if (!out) {
+      usage(argv[0]);
+      return -1;
+    }
 
-  /* Set workload file */
-  fp = open_workload(argv[1]);
-  if (!fp)
+    n = convert_trace(argv[optind], out);
+    if (n < 0) {
+      printf("FAIL convert\n");
+      return -1;
+    }
+
+    printf("OK convert %lld records\n", n);
+    return 0;
+  }
+
+  /* Set workload file (csv or binary) */
+  t = open_trace(argv[optind]);
+  if (!t) {
     printf("FAIL open\n");
-  else
-    printf("OK open\n");
+    return -1;
+  }
+  printf("OK open\n");
+
+  /* LRU miss ratio curve */
+  if (strcmp(mode, "mrc") == 0) {
+    fp = out ? fopen(out, "w") : stdout;
+    if (!fp || nblock <= 0 || run_mrc(t, block, nblock, fp) < 0) {
+      printf("FAIL mrc\n");
+      ret = -1;
+    }
+
+    if (fp && fp != stdout)
+      fclose(fp);
+    close_trace(t);
+    return ret;
+  }
+
+  /* Sampled LRU miss ratio curve */
+  if (strcmp(mode, "shards") == 0) {
+    fp = out ? fopen(out, "w") : stdout;
+    if (!fp || nblock <= 0 || run_shards(t, block, nblock, rate, fp) < 0) {
+      printf("FAIL shards\n");
+      ret = -1;
+    }
+
+    if (fp && fp != stdout)
+      fclose(fp);
+    close_trace(t);
+    return ret;
+  }
+
+  /* Cache size x block size sweep */
+  if (strcmp(mode, "sweep") == 0) {
+    fp = out ? fopen(out, "w") : NULL;
+    if ((out && !fp) || nsize <= 0 || nblock <= 0 ||
+        run_sweep(t, size, nsize, block, nblock, policy, npolicy, &conf, 1, nthread, fp) < 0) {
+      printf("FAIL sweep\n");
+      ret = -1;
+    }
+
+    if (fp)
+      fclose(fp);
+    close_trace(t);
+    return ret;
+  }
+
+  /* Mini simulation. dozens of scaled caches on sampled stream */
+  if (strcmp(mode, "mini") == 0) {
+    if (!nsize_opt) {
+      for (nsize = 0; nsize <= 9 * SWEEP_MINI_STEP && nsize < SWEEP_MAX_SIZE; nsize++)
+        size[nsize] = (long)exp2(MRC_MIN_SHIFT + (double)nsize / SWEEP_MINI_STEP);
+    }
+
+    fp = out ? fopen(out, "w") : NULL;
+    if ((out && !fp) || nsize <= 0 || nblock <= 0 || rate <= 0 || rate > 1 ||
+        run_sweep(t, size, nsize, block, nblock, policy, npolicy, &conf, rate, nthread, fp) < 0) {
+      printf("FAIL mini\n");
+      ret = -1;
+    }
+
+    if (fp)
+      fclose(fp);
+    close_trace(t);
+    return ret;
+  }
+
+  /* Offline optimal. ($TMPDIR keeps next use array) */
+  if (strcmp(mode, "min") == 0) {
+    fp = out ? fopen(out, "w") : NULL;
+    if ((out && !fp) || nsize <= 0 || nblock <= 0 ||
+        run_min(t, size, nsize, block, nblock, fp) < 0) {
+      printf("FAIL min\n");
+      ret = -1;
+    }
+
+    if (fp)
+      fclose(fp);
+    close_trace(t);
+    return ret;
+  }
+
+  /* Trace analysis. reuse distance, irt, footprint */
+  if (strcmp(mode, "reuse") == 0) {
+    fp = out ? fopen(out, "w") : NULL;
+    if ((out && !fp) || nblock <= 0 || run_reuse(t, block, nblock, step, span, fp) < 0) {
+      printf("FAIL reuse\n");
+      ret = -1;
+    }
+
+    if (fp)
+      fclose(fp);
+    close_trace(t);
+    return ret;
+  }
+
+  /* Hash function bench. (table size = cache size if given) */
+  if (strcmp(mode, "hash") == 0) {
+    if (run_hash_bench(t, optind + 1 < argc ? atol(argv[optind + 1]) * MB : 0) < 0) {
+      printf("FAIL hash\n");
+      ret = -1;
+    }
+
+    close_trace(t);
+    return ret;
+  }
+
+  if (optind + 1 >= argc) {
+    usage(argv[0]);
+    close_trace(t);
+    return -1;
+  }
 
   /* Read MAIN function */
-  /* read_workload(fp, atol(argv[2]) * 1024 * 1024); */
-  read_workload(fp, atol(argv[2]) * 1024 * 1024);
+  fp = out ? fopen(out, "w") : NULL;
+  if (out && !fp) {
+    printf("FAIL sim\n");
+    close_trace(t);
+    return -1;
+  }
+
+  n = read_workload(t, atol(argv[optind + 1]) * 1024 * 1024, &conf, fp, step, span);
+  if (n < 0)
+    printf("FAIL sim\n");
 
-end:
-  fclose(fp);
-  return 0;
+  if (fp)
+    fclose(fp);
+  close_trace(t);
+  return n < 0 ? -1 : 0;
 
 }